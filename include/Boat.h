@@ -32,15 +32,23 @@ public:
     ~Boat();
 
     wxString OpenXML(wxString filename, bool shortcut=true);
+    bool IsLoaded(wxString filename) const;
     wxString SaveXML(wxString filename);
 
     std::vector<Polar> Polars;
 
-    int TrySwitchPolar(int curpolar, double VW, double H, double Swell, bool optimize_tacking);
+    int TrySwitchPolar(int curpolar, double VW, double H, double Swell, bool optimize_tacking) const;
     bool FastestPolar(int p, float H, float VW);
     void GenerateCrossOverChart(void *arg=0, void (*status)(void *, int, int)=0);
+    void MergeCrossOverChart(const Boat &generated);
 
 private:
+    friend class CrossOverThread;
+
+    void SampleCrossOverSpeeds(int p, int H0i, int H1i, float *speeds);
+    void TraceCrossOverSegments(int p, int H0i, int H1i, std::list<Segment> &segments);
+    void RunCrossOverThreads(int p, float *speeds, std::list<Segment> *segments);
+
     Point Interp(const Point &p0, const Point &p1, int q, bool q0, bool q1);
     void NewSegment(Point &p0, Point &p1, std::list<Segment> &segments);
     void GenerateSegments(float H, float VW, float step, bool q[4],
@@ -48,4 +56,7 @@ private:
 
     wxString   m_last_filename;
     wxDateTime m_last_filetime;
+
+    /* speed grids the cross over chart was last generated with */
+    std::vector<std::shared_ptr<const std::vector<float> > > m_CrossOverSpeeds;
 };
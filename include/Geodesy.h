@@ -0,0 +1,52 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN Weather Routing plugin
+ * Author:   Sean D'Epagnier
+ *
+ ***************************************************************************
+ *   Copyright (C) 2016 by Sean D'Epagnier                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#ifndef _GEODESY_H_
+#define _GEODESY_H_
+
+/* positions and distances from one origin, sin and cos of the origin are
+   computed once and reused for every heading propagated from it.
+
+   ELLIPSOIDAL is the exact geodesic of georef (ll_gc_ll),
+   SPHERICAL a great circle on the mean earth radius and
+   LOCAL_TANGENT a flat plane at the origin, only valid for short steps. */
+class Geodesy
+{
+public:
+    enum Mode { ELLIPSOIDAL, SPHERICAL, LOCAL_TANGENT };
+
+    Geodesy(double lat, double lon, Mode mode);
+
+    /* brg in degrees, dist in nautical miles, dlon is -180 to 180 */
+    void Destination(double brg, double dist, double *dlat, double *dlon) const;
+    void Reverse(double lat2, double lon2, double *brg, double *dist) const;
+
+private:
+    double m_lat, m_lon;
+    Mode m_Mode;
+    double m_sinlat, m_coslat;
+};
+
+#endif
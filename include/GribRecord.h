@@ -135,6 +135,7 @@ class GribCode
 //----------------------------------------------
 class GribRecord
 {
+    friend class GribTile;
     public:
         GribRecord(const GribRecord &rec);
         GribRecord() { m_bfilled = false;}
@@ -304,6 +305,47 @@ class GribRecord
 //        void   print();
 };
 
+//----------------------------------------------
+// Result of GribTile::SampleAll, vectors are given as getInterpolatedValues
+// would return them (magnitude in m/s, direction in degrees)
+struct GribTileSample
+{
+    bool has_current, has_swell, has_gust; // field is stored in the tile
+    bool wind, current;                    // vector is defined at this point
+    double VW, W, VC, C;
+    double swell, gust;                    // GRIB_NOTDEF if not defined
+};
+
+//----------------------------------------------
+// Interleaved copy of the records sharing the wind grid, so that all the
+// fields needed at a point are interpolated from one index computation
+// and adjacent memory instead of one lookup per record.
+class GribTile
+{
+    public:
+        enum { WIND_VX, WIND_VY, CURRENT_VX, CURRENT_VY, HTSIGW, WIND_GUST, FIELDS };
+
+        // records[WIND_VX] and records[WIND_VY] are required, others may be NULL
+        GribTile(const GribRecord *records[FIELDS]);
+        ~GribTile() { delete [] data; }
+
+        bool isOk() const { return data != NULL; }
+        void SampleAll(double px, double py, GribTileSample &sample) const;
+
+    private:
+        bool SameGrid(const GribRecord *rec) const;
+        double ScalarValue(int field, const float *c00, const float *c10,
+                           const float *c01, const float *c11,
+                           double dx, double dy, double px, double py) const;
+        bool VectorValue(int fieldx, const float *c00, const float *c10,
+                         const float *c01, const float *c11,
+                         double dx, double dy, double &M, double &A) const;
+
+        const GribRecord *records[FIELDS];
+        bool has[FIELDS];
+        float *data; // FIELDS values per grid point, NAN where undefined
+};
+
 //==========================================================================
 inline bool   GribRecord::hasValue(int i, int j) const
 {
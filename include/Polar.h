@@ -24,6 +24,7 @@
  */
 
 #include <vector>
+#include <memory>
 #include "PolygonRegion.h"
 
 struct SailingVMG
@@ -44,6 +45,12 @@ class Boat;
 
 #define DEGREES 360
 
+/* resolution of the dense speed table */
+#define DENSE_DEGREE_STEP .5
+#define DENSE_WIND_STEP .25
+#define DENSE_MAX_WIND_STEPS 512
+#define DENSE_MAX_SPREAD .25 /* knots between neighbours, beyond use the polar */
+
 class Polar
 {
 public:
@@ -61,16 +68,17 @@ public:
     wxString FileName;
 
     void OptimizeTackingSpeeds();
-    void ClosestVWi(double VW, int &VW1i, int &VW2i);
+    void ClosestVWi(double VW, int &VW1i, int &VW2i) const;
 
-    double Speed(double W, double VW, bool bound=false, bool optimize_tacking=false);
+    double Speed(double W, double VW, bool bound=false, bool optimize_tacking=false) const;
     double SpeedAtApparentWindDirection(double A, double VW, double *pW=0);
     double SpeedAtApparentWindSpeed(double W, double VA);
     double SpeedAtApparentWind(double A, double VA, double *pW=0);
 
-    double MinDegreeStep() { return degree_steps[0]; }
+    double MinDegreeStep() const { return degree_steps[0]; }
+    double MaxSpeed() const;
 
-    SailingVMG GetVMGTrueWind(double VW);
+    SailingVMG GetVMGTrueWind(double VW) const;
     SailingVMG GetVMGApparentWind(double VA);
 
     double TrueWindSpeed(double VB, double W, double maxVW);
@@ -78,7 +86,7 @@ public:
     void UpdateSpeeds();
     void UpdateDegreeStepLookup();
 
-    bool InsideCrossOverContour(float H, float VW, bool optimize_tacking);
+    bool InsideCrossOverContour(float H, float VW, bool optimize_tacking) const;
     PolygonRegion CrossOverRegion;
 
     void Generate(const std::list<PolarMeasurement> &measurements);
@@ -92,6 +100,7 @@ public:
 private:
     friend class EditPolarDialog;
     friend class BoatDialog;
+    friend class Boat;
 
     void CalculateVMG(int speed);
 
@@ -106,9 +115,27 @@ private:
         std::vector<float> orig_speeds; // by degree_count, from polar file
         SailingVMG VMG;
     }; // num_wind_speeds
-    bool VMGAngle(SailingWindSpeed &ws1, SailingWindSpeed &ws2, float VW, float &W);
+    bool VMGAngle(const SailingWindSpeed &ws1, const SailingWindSpeed &ws2, float VW, float &W) const;
+
+    void UpdateDenseSpeeds();
+    double DenseSpeed(double W, double VW, bool optimize_tacking) const;
 
     std::vector<SailingWindSpeed> wind_speeds;
     std::vector<double> degree_steps;
     unsigned int degree_step_index[DEGREES];
+
+    /* speeds resampled on a regular grid so a lookup is a single bilinear fetch,
+       pairs of speed and tacking optimized speed, by wind speed then degree */
+    std::vector<float> dense_speeds;
+    double dense_VW0, dense_VW_step;
+    int dense_VW_count;
+    double max_speed;
+
+    /* speeds sampled on the cross over chart grid and the cells this polar was
+       fastest in, kept by Boat::GenerateCrossOverChart to only redo what an edit
+       changed; stale once speeds_version moves past crossover_version */
+    std::shared_ptr<const std::vector<float> > crossover_speeds;
+    std::shared_ptr<const std::vector<char> > crossover_fastest;
+    double crossover_percentage;
+    unsigned int speeds_version, crossover_version;
 };
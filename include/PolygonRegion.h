@@ -79,7 +79,7 @@ public:
 
     std::string toString();
 
-    bool Contains(float x, float y);
+    bool Contains(float x, float y) const;
 
     void Intersect(PolygonRegion &region);
     void Union(PolygonRegion &region);
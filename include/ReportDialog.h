@@ -23,6 +23,9 @@
  ***************************************************************************
  */
 
+#include <list>
+#include <map>
+
 #include "WeatherRoutingUI.h"
 
 class RouteMapOverlay;
@@ -33,8 +36,9 @@ public:
     ReportDialog( WeatherRouting &weatherrouting );
 
     void SetRouteMapOverlays(std::list<RouteMapOverlay*> routemapoverlays);
+    void RouteFinished(RouteMapOverlay *routemapoverlay);
 
-    bool m_bReportStale;
+    bool m_bReportStale; /* regroup every route, otherwise only stale groups are redone */
 
 protected:
     void GenerateRoutesReport();
@@ -42,6 +46,31 @@ protected:
     void OnClose( wxCommandEvent& event ) { Hide(); }
 
 private:
+    /* values reported for a route, read from the route the first time its group is redone */
+    struct ReportedRoute {
+        ReportedRoute(RouteMapOverlay *r) : routemapoverlay(r), computed(false) {}
+        RouteMapOverlay *routemapoverlay;
+        bool computed;
+        wxDateTime start, end;
+        double avgspeed, upwind;
+        int comfort;
+        int cyclones; /* -1 if climatology is unavailable */
+        int cyclonemonths[12];
+    };
+
+    /* routes with the same start and end in order of start time */
+    struct RouteGroup {
+        RouteGroup() : stale(true) {}
+        std::list<ReportedRoute> routes;
+        wxString page;
+        bool stale;
+    };
+
+    void AddRoute(RouteMapOverlay *routemapoverlay);
+    void GenerateGroupReport(RouteGroup &group);
+
+    std::map<wxString, RouteGroup> m_RouteGroups;
+
     wxDateTime DisplayedTime(wxDateTime t);
     wxString FormatTime(wxDateTime t);
     WeatherRouting &m_WeatherRouting;
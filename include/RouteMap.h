@@ -26,11 +26,16 @@
 #include "wx/datetime.h"
 #include <wx/object.h>
 #include <wx/weakref.h>
+#include <wx/thread.h>
 
 #include <list>
+#include <vector>
+#include <memory>
+#include <atomic>
 
 #include "ODAPI.h"
 #include "GribRecordSet.h"
+#include "Geodesy.h"
 
 struct RouteMapConfiguration;
 class IsoRoute;
@@ -53,12 +58,14 @@ public:
     bool grib_is_data_deficient;
 
     bool GetPlotData(RoutePoint *next, double dt, RouteMapConfiguration &configuration, PlotData &data);
+    bool ReadPlotData(RouteMapConfiguration &configuration, PlotData &data);
     bool GetWindData(RouteMapConfiguration &configuration, double &W, double &VW, int &data_mask);
     bool GetCurrentData(RouteMapConfiguration &configuration, double &C, double &VC, int &data_mask);
 
     bool CrossesLand(double dlat, double dlon);
     bool EntersBoundary(double dlat, double dlon);
-    double PropagateToPoint(double dlat, double dlon, RouteMapConfiguration &cf, double &H, int &data_mask, bool end = true);
+    double PropagateToPoint(double dlat, double dlon, RouteMapConfiguration &cf, double &H,
+                            int &data_mask, int &newpolar, bool end = true);
 };
 
 class PlotData : public RoutePoint
@@ -71,6 +78,13 @@ public:
 };
 
 class SkipPosition;
+struct climatology_wind_atlas;
+
+/* conditions read at a position while propagating from it */
+struct PositionConditions
+{
+    float WG, VWG, W, VW, C, VC, WVHT, VW_GUST;
+};
 
 /* circular linked list node for positions which take equal time to reach */
 class Position: public RoutePoint
@@ -87,7 +101,9 @@ public:
 
     double Distance(Position *p);
     int SailChanges();
-    double PropagateToEnd(RouteMapConfiguration &configuration, double &H, int &data_mask);
+    double PropagateToEnd(RouteMapConfiguration &configuration, double &H, int &data_mask, int &newpolar);
+    bool Obstructed(double dlat, double dlon, double BG, double dist, const Geodesy &origin,
+                    RouteMapConfiguration &configuration);
    
     double parent_heading; /* angle relative to true wind we sailed from parent to this position */
     double parent_bearing; /* angle relative to north */
@@ -98,10 +114,24 @@ public:
     bool propagated;
     bool drawn, copied;
 
+    /* set by Propagate so plots need not read the gribs again,
+       never copied since copies are at a later time.  The isochron may
+       already be published, so conditions are written before sampled
+       is released, and readers acquire sampled before the conditions */
+    std::atomic<bool> sampled;
+    PositionConditions conditions;
+
+    bool deferred; /* land, boundaries and cyclone tracks from the parent not tested yet */
+
     // used for rendering
     enum DataMask { GRIB_WIND=1, CLIMATOLOGY_WIND=2, DATA_DEFICIENT_WIND=4,
                     GRIB_CURRENT=8, CLIMATOLOGY_CURRENT=16, DATA_DEFICIENT_CURRENT=32 };
     int data_mask;
+
+private:
+    Position *PropagateHeading(double H, RouteMapConfiguration &configuration, const Geodesy &origin,
+                               double WG, double VWG, double W, double VW, double C, double VC,
+                               double S, climatology_wind_atlas &atlas, int &data_mask);
 };
 
 /* circular skip list of positions which point to where we
@@ -121,6 +151,26 @@ public:
     int quadrant;
 };
 
+/* longitude bands over the edges of a finished route, each band holds
+   the edges which span it so a point only tests edges crossing its meridian */
+class IsoRouteIndex
+{
+public:
+    IsoRouteIndex(IsoRoute *r);
+
+    int IntersectionCount(double lat, double lon) const;
+    void Crossings(double lon, std::vector<double> &lats) const;
+
+private:
+    struct Edge { double lat1, lon1, lat2, lon2; };
+
+    int Band(double lon) const;
+
+    double m_MinLon, m_MaxLon, m_BandsPerDegree;
+    std::vector<int> m_BandStart; /* offset of each band in m_Edges, plus end */
+    std::vector<Edge> m_Edges;
+};
+
 /* a closed loop of positions */
 class IsoRoute
 {
@@ -135,6 +185,8 @@ public:
     void MinimizeLat();
     int IntersectionCount(Position &pos);
     int Contains(Position &pos, bool test_children);
+    void Crossings(double lon, std::vector<double> &lats);
+    void BuildIndex();
 
     bool CompletelyContained(IsoRoute *r);
     bool ContainsRoute(IsoRoute *r);
@@ -146,8 +198,7 @@ public:
     void RemovePosition(SkipPosition *s, Position *p);
     Position *ClosestPosition(double lat, double lon, double *dist=0);
     bool Propagate(IsoRouteList &routelist, RouteMapConfiguration &configuration);
-    void PropagateToEnd(RouteMapConfiguration &configuration, double &mindt,
-                        Position *&endp, double &minH, bool &mintacked, int &mindata_mask);
+    void AppendPositions(std::vector<Position*> &positions);
 
     int SkipCount();
     int Count();
@@ -160,12 +211,14 @@ public:
     
     IsoRoute *parent; /* outer region if a child */
     IsoRouteList children; /* inner inverted regions */
+
+    IsoRouteIndex *index; /* only for routes which no longer change */
 };
 
 // -----------------
 class WR_GribRecordSet {
 public:
-    WR_GribRecordSet(unsigned int id) : m_Reference_Time(-1), m_ID(id) {
+    WR_GribRecordSet(unsigned int id) : m_Reference_Time(-1), m_ID(id), m_Tile(0) {
         for(int i=0; i<Idx_COUNT; i++) {
             m_GribRecordPtrArray[i] = 0;
             m_GribRecordUnref[i] = false;
@@ -174,9 +227,28 @@ public:
 
     virtual ~WR_GribRecordSet()
     {
+         delete m_Tile;
          RemoveGribRecords();
     }
 
+    /* interleave the records used for routing, call once all records are set */
+    void BuildTile() {
+        const GribRecord *records[GribTile::FIELDS];
+        records[GribTile::WIND_VX] = m_GribRecordPtrArray[Idx_WIND_VX];
+        records[GribTile::WIND_VY] = m_GribRecordPtrArray[Idx_WIND_VY];
+        records[GribTile::CURRENT_VX] = m_GribRecordPtrArray[Idx_SEACURRENT_VX];
+        records[GribTile::CURRENT_VY] = m_GribRecordPtrArray[Idx_SEACURRENT_VY];
+        records[GribTile::HTSIGW] = m_GribRecordPtrArray[Idx_HTSIGW];
+        records[GribTile::WIND_GUST] = m_GribRecordPtrArray[Idx_WIND_GUST];
+
+        delete m_Tile;
+        m_Tile = new GribTile(records);
+        if(!m_Tile->isOk()) {
+            delete m_Tile;
+            m_Tile = 0;
+        }
+    }
+
     /* copy and paste by plugins, keep functions in header */
     void SetUnRefGribRecord(int i, GribRecord *pGR ) { 
         assert (i >= 0 && i < Idx_COUNT);
@@ -199,6 +271,7 @@ public:
     unsigned int m_ID;
 
     GribRecord *m_GribRecordPtrArray[Idx_COUNT];
+    GribTile *m_Tile; // NULL if the wind records are missing
 private:
     // grib records files are stored and owned by reader mapGribRecords
     // interpolated grib are not, keep track of them
@@ -278,8 +351,11 @@ public:
     ~IsoChron();
 
     void PropagateIntoList(IsoRouteList &routelist, RouteMapConfiguration &configuration);
+    void PropagateToEnd(RouteMapConfiguration &configuration, double &mindt, Position *&endp,
+                        double &minH, bool &mintacked, int &mindata_mask, int &minpolar);
     bool Contains(Position &p);
     bool Contains(double lat, double lon);
+    void Contains(double lon, const std::vector<double> &lats, std::vector<bool> &inside);
     Position *ClosestPosition(double lat, double lon, wxDateTime *t = 0, double *dist=0);
     void ResetDrawnFlag();
 
@@ -291,7 +367,20 @@ public:
     bool m_Grib_is_data_deficient;
 };
 
-typedef std::list<IsoChron*> IsoChronList;
+/* isochrons in order of time, a published list is never modified so
+   readers walk a snapshot without locking while the worker appends */
+typedef std::vector<std::shared_ptr<IsoChron> > IsoChronList;
+typedef std::shared_ptr<const IsoChronList> IsoChronSnapshot;
+
+/* route found by a coarse pass, the fine pass does not
+   propagate positions further than range miles from it */
+struct RouteCorridor {
+    double Distance(double lat, double lon) const;
+    bool Contains(double lat, double lon) const { return Distance(lat, lon) <= range; }
+
+    std::vector<double> lats, lons;
+    double range;
+};
 
 struct RouteMapPosition {
     RouteMapPosition(wxString n, double lat0, double lon0, wxString guid = wxEmptyString)
@@ -307,8 +396,18 @@ struct RouteMapPosition {
 
 struct RouteMapConfiguration {
     RouteMapConfiguration () : StartLon(0), EndLon(0), 
-          grib(nullptr), grib_is_data_deficient(false) {} /* avoid waiting forever in update longitudes */
+          grib(nullptr), grib_is_data_deficient(false), GoalRange(NAN), /* avoid waiting forever in update longitudes */
+          m_Boat(std::make_shared<Boat>()), m_DegreeSteps(std::make_shared<std::vector<double> >()) {}
     bool Update();
+    wxString LoadBoat();
+
+    /* the boat and degree steps are const and shared by all copies of a
+       configuration, so copying the configuration for each step or frame
+       does not copy the polars */
+    const Boat &GetBoat() const { return *m_Boat; }
+    void ShareBoat(const RouteMapConfiguration &o) { m_Boat = o.m_Boat; }
+    const std::vector<double> &GetDegreeSteps() const { return *m_DegreeSteps; }
+    void CoarsenDegreeSteps(int factor);
 
     wxString RouteGUID;       /* Route GUID if any */
     wxString Start;
@@ -322,30 +421,36 @@ struct RouteMapConfiguration {
     double DeltaTime; /* default time in seconds between propagations */
     double UsedDeltaTime; /* time in seconds between propagations */
 
-    Boat boat;
     wxString boatFileName;
     
     enum IntegratorType { NEWTON, RUNGE_KUTTA } Integrator;
+    Geodesy::Mode GeodesyMode; /* used while propagating, routes are always ellipsoidal */
 
     double MaxDivertedCourse, MaxCourseAngle, MaxSearchAngle, MaxTrueWindKnots, MaxApparentWindKnots;
     double MaxSwellMeters, MaxLatitude, TackingTime, WindVSCurrent;
     double SafetyMarginLand;
+    double MaxPassageHours; /* positions which cannot arrive in time are not propagated, 0 for no limit */
+    double CorridorMiles; /* first find a coarse route and only propagate near it, 0 for one pass */
 
     bool AvoidCycloneTracks;
     int CycloneMonths, CycloneDays;
+    bool CycloneCells; /* test grid cells for tracks first, faster but may miss a track inside a cell */
 
     bool UseGrib;
+    int PrefetchDepth; /* grib time slices requested ahead of the propagation */
     enum ClimatologyDataType {DISABLED, CURRENTS_ONLY, CUMULATIVE_MAP, CUMULATIVE_MINUS_CALMS, MOST_LIKELY, AVERAGE};
     enum ClimatologyDataType ClimatologyType;
     bool AllowDataDeficient;
     double WindStrength; // wind speed multiplier
 
     bool DetectLand, DetectBoundary, Currents, OptimizeTacking, InvertedRegions, Anchoring;
+    bool ShareIsochrons; /* follow a computation which only differs in destination */
+    bool AdaptiveHeadings; /* refine a coarse fan of headings only where positions are sparse */
+    bool DeferValidation; /* test land, boundaries and cyclone tracks only on merged isochrons */
 
     double FromDegree, ToDegree, ByDegrees;
 
     /* computed values */
-    std::list<double> DegreeSteps;
     double StartLat, StartLon, EndLat, EndLon;
 
     double StartEndBearing; /* calculated from start and end */
@@ -359,10 +464,24 @@ struct RouteMapConfiguration {
     wxDateTime time;
     bool grib_is_data_deficient, polar_failed, wind_data_failed;
     bool land_crossing, boundary_crossing;
+    double GoalRange; /* miles the boat can still sail before the arrival bound, NAN for none */
+    /* while leading, land and boundaries are tested only up to the closest of
+       these and the own destination */
+    std::shared_ptr<const std::vector<std::pair<double, double> > > FollowerDestinations;
+    std::shared_ptr<const RouteCorridor> corridor;
+
+private:
+    std::shared_ptr<const Boat> m_Boat;
+    std::shared_ptr<const std::vector<double> > m_DegreeSteps;
 };
 
 bool operator!=(const RouteMapConfiguration &c1, const RouteMapConfiguration &c2);
 
+/* steps of the coarse pass are this many times longer and its headings
+   this many times further apart than configured */
+#define COARSE_TIME_FACTOR 4
+#define COARSE_DEGREE_FACTOR 3
+
 class RouteMap
 {
 public:
@@ -383,12 +502,14 @@ public:
     LOCKING_ACCESSOR(LandCrossing, m_bLandCrossing)
     LOCKING_ACCESSOR(BoundaryCrossing, m_bBoundaryCrossing)
 
-    bool Empty() { Lock(); bool empty = origin.size() == 0; Unlock(); return empty; }
-    bool NeedsGrib() { Lock(); bool needsgrib = m_bNeedsGrib; Unlock(); return needsgrib; }
-    void RequestedGrib() { Lock(); m_bNeedsGrib=false; Unlock(); }
+    bool Empty() { return Origin()->empty(); }
+    bool NeedsGrib();
+    Shared_GribRecordSet RequestedGrib(const wxDateTime &time);
     void SetNewGrib(GribRecordSet *grib);
     void SetNewGrib(WR_GribRecordSet *grib);
+    void SetSharedGrib(const Shared_GribRecordSet &grib);
     wxDateTime NewTime() { Lock(); wxDateTime time =  m_NewTime; Unlock(); return time; }
+    wxDateTime GribRequestTime() { Lock(); wxDateTime time = m_GribRequestTime; Unlock(); return time; }
     wxDateTime StartTime() { Lock(); wxDateTime time = m_Configuration.StartTime;
         Unlock(); return time; }
 
@@ -410,11 +531,20 @@ public:
                                                    const wxDateTime &date, int dayrange);
 
     static OD_FindClosestBoundaryLineCrossing ODFindClosestBoundaryLineCrossing;
+    static void SetODFindClosestBoundaryLineCrossing(OD_FindClosestBoundaryLineCrossing f);
+    static void ClearClimatologyCache(); /* after the climatology plugin changed */
     
     static std::list<RouteMapPosition> Positions;
     void Stop() { Lock(); m_bFinished = true; Unlock(); }
     void ResetFinished() { Lock(); m_bFinished = false; Unlock(); }
-    wxString LoadBoat() { return m_Configuration.boat.OpenXML(m_Configuration.boatFileName); }
+    wxString LoadBoat();
+
+    /* one to many: maps from the same start to other destinations follow the
+       isochrons this map propagates instead of propagating their own, so the
+       propagation continues without destination pruning until all are reached */
+    void AddFollower(RouteMap *follower);
+    void RemoveFollower(RouteMap *follower);
+    void ReleaseFollowers();
 
     // XXX Isn't wxString refcounting thread safe?
     wxString GetError() { Lock(); wxString ret = m_ErrorMsg; Unlock(); return ret; }
@@ -449,7 +579,9 @@ protected:
     }
 
     virtual void Clear();
+    virtual void FollowerUpdated(RouteMap *follower) {}
     bool ReduceList(IsoRouteList &merged, IsoRouteList &routelist, RouteMapConfiguration &configuration);
+    bool ReduceValidated(IsoRouteList &merged, IsoRouteList &routelist, RouteMapConfiguration &configuration);
     Position *ClosestPosition(double lat, double lon, wxDateTime *t=0, double *dist=0);
 
     /* protect any member variables with mutexes if needed */
@@ -457,13 +589,45 @@ protected:
     virtual void Unlock() = 0;
     virtual bool TestAbort() = 0;
 
-    IsoChronList origin; /* list of route isos in order of time */
+    IsoChronSnapshot Origin() const { return std::atomic_load(&m_Origin); }
+    bool Publish(IsoChronSnapshot snapshot, IsoChron *update, bool visible);
     bool m_bNeedsGrib;
     Shared_GribRecordSet m_SharedNewGrib;
     WR_GribRecordSet *m_NewGrib;
 
+    /* gribs requested by the main thread ahead of m_NewTime, in order of time */
+    struct PrefetchedGrib {
+        wxDateTime time;
+        Shared_GribRecordSet grib;
+        size_t size;
+    };
+    std::list<PrefetchedGrib> m_PrefetchedGribs;
+    size_t m_PrefetchedSize; /* also counted in the total of all route maps */
+    void PopPrefetchedGrib();
+    void ClearPrefetchedGribs();
+    wxDateTime m_GribRequestTime; /* time of the next grib to request */
+
 private:
  
+    void UpdateFollowers(IsoChronSnapshot snapshot, const RouteMapConfiguration &configuration);
+    double DeltaTime() const { return m_Configuration.DeltaTime * (m_bCoarsePass ? COARSE_TIME_FACTOR : 1); }
+    void StartFinePass(IsoChron *coarse);
+
+    IsoChronSnapshot m_Origin; /* only replaced by the worker, or Clear */
+    /* isochrons propagated so far, past m_Origin once the destination is
+       reached while followers still need further isochrons */
+    IsoChronSnapshot m_Propagation;
+    std::list<RouteMap*> m_Followers;
+    wxMutex m_FollowersMutex; /* taken before Lock() */
+    /* followers whose destination is updated after m_FollowersMutex is released,
+       and whether they reached it */
+    std::list<std::pair<RouteMap*, bool> > m_PendingFollowers;
+    RouteMap *m_UpdatingFollower;
+    wxCondition m_FollowerUpdated; /* m_UpdatingFollower changed */
+    bool m_bLeading; /* had followers since the reset */
+    /* propagating with longer steps and fewer headings to find the corridor */
+    bool m_bCoarsePass;
+    std::shared_ptr<const RouteCorridor> m_Corridor;
     RouteMapConfiguration m_Configuration;
     bool m_bFinished, m_bValid;
     bool m_bReachedDestination, m_bGribFailed, m_bPolarFailed, m_bNoData;
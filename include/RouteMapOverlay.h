@@ -67,7 +67,7 @@ public:
     void RenderCurrent(piDC &dc, PlugIn_ViewPort &vp);
 
     void GetLLBounds(double &latmin, double &latmax, double &lonmin, double &lonmax);
-    void RequestGrib(wxDateTime time);
+    Shared_GribRecordSet RequestGrib(wxDateTime time);
 
     std::list<PlotData> &GetPlotData(bool cursor_route=false);
     double RouteInfo(enum RouteInfoType type, bool cursor_route=false);
@@ -83,11 +83,16 @@ public:
     virtual void Clear();
     virtual void Lock() { routemutex.Lock(); }
     virtual void Unlock() { routemutex.Unlock(); }
-    bool Running() { return m_Thread && m_Thread->IsAlive(); }
+    bool Running() { return (m_Thread && m_Thread->IsAlive()) || (m_Leader && !Finished()); }
 
     bool Start(wxString &error);
     void DeleteThread(); // like Stop(), but waits until the thread is deleted
 
+    /* take the isochrons of a map only differing in destination, main thread only */
+    void Follow(RouteMapOverlay *leader);
+    void Unfollow();
+    bool Following() { return m_Leader != NULL; }
+
     Position *GetLastCursorPosition() { return last_cursor_position; }
     wxDateTime GetLastCursorTime() { return m_cursor_time; }
     
@@ -104,6 +109,19 @@ private:
 
     void RenderIsoRoute(IsoRoute *r, wxColour &grib_color, wxColour &climatology_color,
                         piDC &dc, PlugIn_ViewPort &vp);
+
+    /* isochron lines in mercator meters from the start position, built once
+       for each isochron so opengl frames only need a new transform.
+       Each level drops points within LOD_TOLERANCE*LOD_FACTOR^(level-1) meters
+       of the line, the level drawn is picked from the viewport scale */
+    enum {LOD_LEVELS = 6};
+    struct IsoChronLines {
+        std::vector<float> vertices[LOD_LEVELS];
+        std::vector<unsigned char> colors[LOD_LEVELS];
+    };
+    void PushIsoRouteLines(IsoRoute *r, wxColour &grib_color, wxColour &climatology_color,
+                           IsoChronLines &lines);
+    void DrawIsoChronLines(PlugIn_ViewPort &vp);
     void RenderPolarChangeMarks(bool cursor_route,  piDC &dc, PlugIn_ViewPort &vp);
     void RenderBoatOnCourse(bool cursor_route,  wxDateTime time, piDC &dc, PlugIn_ViewPort &vp);
 
@@ -115,11 +133,26 @@ private:
 
     int sailingConditionLevel(const PlotData &plot) const;
 
+    /* every RouteInfo statistic of a plot data list, computed in one pass
+       and kept until GetPlotData rebuilds the list */
+    struct RouteSummary {
+        RouteSummary() : valid(false) {}
+        bool valid;
+        double values[COMFORT+1];
+        double lastlat, lastlon; /* to add the final leg once finished */
+    };
+    void UpdateRouteSummary(std::list<PlotData> &plotdata, RouteSummary &summary);
+    RouteSummary m_RouteSummary[2]; /* destination, cursor route */
+
     virtual bool TestAbort() { return Finished(); }
+    virtual void FollowerUpdated(RouteMap *follower);
 
     RouteMapOverlayThread *m_Thread;
     wxMutex routemutex;
 
+    RouteMapOverlay *m_Leader;
+    std::list<RouteMapOverlay*> m_FollowerOverlays;
+
     void SetPointColor(piDC &dc, Position *p);
     void DrawLine(RoutePoint *p1, RoutePoint *p2, piDC &dc, PlugIn_ViewPort &vp);
     void DrawLine(RoutePoint *p1, wxColour &color1, RoutePoint *p2, wxColour &color2,
@@ -129,10 +162,15 @@ private:
     Position *last_cursor_position, *destination_position, *last_destination_position;
     wxDateTime m_cursor_time;
     wxDateTime m_EndTime;
+    double m_DestinationDelta; /* seconds from the last position to the destination */
+    IsoChronSnapshot m_DestinationOrigin; /* isochrons the destination was found in */
     bool m_bUpdated;
 
     int m_overlaylist, m_overlaylist_projection;
 
+    std::list<IsoChronLines> m_IsoChronLines;
+    double m_IsoChronLinesLat, m_IsoChronLinesLon;
+
     bool clear_destination_plotdata; // should be volatile
     std::list<PlotData> last_destination_plotdata;
 
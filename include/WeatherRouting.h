@@ -31,6 +31,8 @@
 #include <wx/fileconf.h>
 #include <wx/collpane.h>
 
+#include <map>
+
 #ifdef __OCPN__ANDROID__
 #include <wx/qt/private/wxQtGesture.h>
 #endif
@@ -111,6 +113,10 @@ public:
     std::list<RouteMapOverlay*> CurrentRouteMaps(bool messagedialog = false);
     RouteMapOverlay *FirstCurrentRouteMap();
     RouteMapOverlay *m_RouteMapOverlayNeedingGrib;
+    /* gribs received for running route maps by time, so concurrent configurations
+       such as a wind strength sweep request each time from the grib plugin once,
+       cleared when the grib plugin's timeline changes as another file may be loaded */
+    std::map<wxDateTime, Shared_GribRecordSet> m_RequestedGribs;
 
     void RebuildList();
     std::list<RouteMapOverlay*> m_RunningRouteMaps, m_WaitingRouteMaps;
@@ -285,10 +285,16 @@ class ConfigurationDialogBase : public wxDialog
 		wxStaticText* m_staticText1291;
 		wxSpinCtrl* m_sCycloneDays;
 		wxStaticText* m_staticText130;
+		wxCheckBox* m_cbCycloneCells;
 		wxCheckBox* m_cbInvertedRegions;
 		wxCheckBox* m_cbAnchoring;
+		wxCheckBox* m_cbAdaptiveHeadings;
+		wxCheckBox* m_cbDeferValidation;
+		wxCheckBox* m_cbShareIsochrons;
 		wxStaticText* m_staticText139;
 		wxComboBox* m_cIntegrator;
+		wxStaticText* m_staticText1391;
+		wxComboBox* m_cGeodesyMode;
 		wxStaticText* m_staticText1292;
 		wxSpinCtrl* m_sWindStrength;
 		wxStaticText* m_staticText1301;
@@ -298,6 +304,15 @@ class ConfigurationDialogBase : public wxDialog
 		wxStaticText* m_staticText241;
 		wxSpinCtrl* m_sSafetyMarginLand;
 		wxStaticText* m_staticText1211;
+		wxStaticText* m_staticText242;
+		wxSpinCtrl* m_sPrefetchDepth;
+		wxStaticText* m_staticText1212;
+		wxStaticText* m_staticText243;
+		wxSpinCtrl* m_sMaxPassageHours;
+		wxStaticText* m_staticText1213;
+		wxStaticText* m_staticText244;
+		wxSpinCtrl* m_sCorridorMiles;
+		wxStaticText* m_staticText1214;
 		wxStaticText* m_staticText113;
 		wxStaticText* m_staticText115;
 		wxStaticText* m_staticText117;
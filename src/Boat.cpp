@@ -26,6 +26,8 @@
 #include <wx/wx.h>
 #include <wx/filename.h>
 
+#include <algorithm>
+
 #include "tinyxml.h"
 
 #include "weather_routing_pi.h"
@@ -40,12 +42,18 @@ Boat::~Boat()
 {
 }
 
+/* already loaded, and boat wasn't modified */
+bool Boat::IsLoaded(wxString filename) const
+{
+    return m_last_filename == filename && m_last_filetime.IsValid() &&
+        m_last_filetime == wxFileName(filename).GetModificationTime();
+}
+
 wxString Boat::OpenXML(wxString filename, bool shortcut)
 {
     wxDateTime last_filetime = wxFileName(filename).GetModificationTime();
     /* shortcut if already loaded, and boat wasn't modified */
-    if(shortcut && m_last_filename == filename &&
-       m_last_filetime.IsValid() && m_last_filetime == last_filetime)
+    if(shortcut && IsLoaded(filename))
         return _T("");
 
     bool cleared = false;
@@ -169,7 +177,7 @@ wxString Boat::SaveXML(wxString filename)
     return wxString();
 }
 
-int Boat::TrySwitchPolar(int curpolar, double VW, double H, double Swell, bool optimize_tacking)
+int Boat::TrySwitchPolar(int curpolar, double VW, double H, double Swell, bool optimize_tacking) const
 {
     // are we still valid?
     if(curpolar != -1 && Polars[curpolar].InsideCrossOverContour(H, VW, optimize_tacking))
@@ -220,33 +228,211 @@ bool Boat::FastestPolar(int p, float H, float VW)
     return speed > 0;
 }
 
+/* the cross over chart grid, headings 0 to 180 by wind speeds 0 to 40 knots */
+static const int crossover_stepi = 8;
+static const int crossover_Hcount = 180*crossover_stepi + 1;
+static const int crossover_VWcount = 40*crossover_stepi + 1;
+
+/* samples speeds or traces segments for a band of headings of the cross over chart */
+class CrossOverThread : public wxThread
+{
+public:
+    CrossOverThread(Boat &boat, int p, int H0i, int H1i, float *speeds)
+        : wxThread(wxTHREAD_JOINABLE), m_Boat(boat), m_p(p),
+          m_H0i(H0i), m_H1i(H1i), m_speeds(speeds) {}
+
+    void *Entry() {
+        Work();
+        return 0;
+    }
+
+    void Work() {
+        if(m_speeds)
+            m_Boat.SampleCrossOverSpeeds(m_p, m_H0i, m_H1i, m_speeds);
+        else
+            m_Boat.TraceCrossOverSegments(m_p, m_H0i, m_H1i, m_segments);
+    }
+
+    std::list<Segment> m_segments;
+
+private:
+    Boat &m_Boat;
+    int m_p, m_H0i, m_H1i;
+    float *m_speeds;
+};
+
+void Boat::SampleCrossOverSpeeds(int p, int H0i, int H1i, float *speeds)
+{
+    const float step = 1.0f/crossover_stepi;
+    for(int Hi = H0i; Hi < H1i; Hi++)
+        for(int VWi = 0; VWi < crossover_VWcount; VWi++)
+            speeds[Hi*crossover_VWcount + VWi] = Polars[p].Speed(Hi*step, VWi*step, true);
+}
+
+void Boat::TraceCrossOverSegments(int p, int H0i, int H1i, std::list<Segment> &segments)
+{
+    const float step = 1.0f/crossover_stepi;
+    const std::vector<char> &fastest = *Polars[p].crossover_fastest;
+    for(int Hi = wxMax(H0i, 1); Hi < H1i; Hi++)
+        for(int VWi = 1; VWi < crossover_VWcount; VWi++) {
+            int c0 = (Hi-1)*crossover_VWcount + VWi, c1 = c0 + crossover_VWcount;
+            bool q[4] = {fastest[c0-1] != 0, fastest[c1-1] != 0,
+                         fastest[c0] != 0,   fastest[c1] != 0};
+            if(q[0] == q[1] && q[0] == q[2] && q[0] == q[3])
+                continue; // no segments inside or outside the region
+            GenerateSegments(Hi*step, VWi*step, step, q, segments, p);
+        }
+}
+
+/* split the headings in bands, one per cpu, the last band runs on this thread
+   and the segments are joined in heading order */
+void Boat::RunCrossOverThreads(int p, float *speeds, std::list<Segment> *segments)
+{
+    int count = wxMax(wxThread::GetCPUCount(), 1);
+    std::vector<CrossOverThread*> threads;
+    std::vector<bool> running;
+    for(int i = 0; i < count; i++) {
+        CrossOverThread *thread = new CrossOverThread(*this, p, crossover_Hcount*i/count,
+                                                      crossover_Hcount*(i+1)/count, speeds);
+        bool run = i < count-1 && thread->Create() == wxTHREAD_NO_ERROR &&
+            thread->Run() == wxTHREAD_NO_ERROR;
+        if(!run)
+            thread->Work();
+        threads.push_back(thread);
+        running.push_back(run);
+    }
+
+    for(int i = 0; i < count; i++) {
+        if(running[i])
+            threads[i]->Wait();
+        if(segments)
+            segments->splice(segments->end(), threads[i]->m_segments);
+        delete threads[i];
+    }
+}
+
+static void MarkSpeeds(const std::vector<float> &speeds, std::vector<char> &moved)
+{
+    for(unsigned int c = 0; c < speeds.size(); c++)
+        if(!std::isnan(speeds[c]))
+            moved[c] = 1;
+}
+
+typedef std::vector<std::shared_ptr<const std::vector<float> > > SpeedGrids;
+
+static bool HasGrid(const SpeedGrids &grids, const std::shared_ptr<const std::vector<float> > &grid)
+{
+    return std::find(grids.begin(), grids.end(), grid) != grids.end();
+}
+
+/* each polar is sampled once on the grid rather than for every comparison, only
+   polars edited since the last chart are sampled again, and only regions whose
+   cells or whose boundary's neighbouring speeds changed are traced again */
 void Boat::GenerateCrossOverChart(void *arg, void (*status)(void *, int, int))
 {
-    const int maxVW = 40;
-    const int stepi = 8;
-    float step = 1.0f/stepi;
+    const int count = crossover_Hcount*crossover_VWcount;
+    const int polars = Polars.size();
+
+    std::vector<int> sample;
+    for(int p = 0; p < polars; p++)
+        if(!Polars[p].crossover_speeds ||
+           Polars[p].crossover_version != Polars[p].speeds_version)
+            sample.push_back(p);
+
+    int work = sample.size() + polars, done = 0;
 
-    for(int p = 0; p < (int)Polars.size(); p++) {
+    /* mark cells where any sampled speed moved since the last chart */
+    std::vector<char> moved(count, 0);
+    SpeedGrids accounted;
+    for(unsigned int i = 0; i < sample.size(); i++) {
         if(status)
-            status(arg, p, Polars.size());
+            status(arg, done++, work);
+
+        Polar &polar = Polars[sample[i]];
+        std::vector<float> *speeds = new std::vector<float>(count);
+        RunCrossOverThreads(sample[i], &(*speeds)[0], NULL);
+
+        if(polar.crossover_speeds) {
+            const std::vector<float> &old = *polar.crossover_speeds;
+            for(int c = 0; c < count; c++)
+                if(old[c] != (*speeds)[c] && !(std::isnan(old[c]) && std::isnan((*speeds)[c])))
+                    moved[c] = 1;
+            accounted.push_back(polar.crossover_speeds);
+        } else
+            MarkSpeeds(*speeds, moved);
+
+        polar.crossover_speeds = std::shared_ptr<const std::vector<float> >(speeds);
+        polar.crossover_version = polar.speeds_version;
+        accounted.push_back(polar.crossover_speeds);
+    }
 
-        bool buffer[2][maxVW*stepi+1];
-        int bi = 0;
-        std::list<Segment> segments;
-        for(float H = 0; H <= 180; H+=step) {
-            for(int VWi = 0; VWi <= maxVW*stepi; VWi++) {
-                float VW = VWi * step;
-                buffer[bi][VWi] = FastestPolar(p, H, VW);
-
-                if(VWi > 0 && H > 0) {
-                    bool q[4] = {buffer[!bi][VWi-1], buffer[bi][VWi-1],
-                                 buffer[!bi][VWi],   buffer[bi][VWi]};
-                    GenerateSegments(H, VW, step, q, segments, p);
-                }
+    /* polars added or removed since the last chart */
+    SpeedGrids grids;
+    for(int p = 0; p < polars; p++)
+        grids.push_back(Polars[p].crossover_speeds);
+    for(SpeedGrids::iterator it = m_CrossOverSpeeds.begin(); it != m_CrossOverSpeeds.end(); it++)
+        if(!HasGrid(grids, *it) && !HasGrid(accounted, *it))
+            MarkSpeeds(**it, moved);
+    for(SpeedGrids::iterator it = grids.begin(); it != grids.end(); it++)
+        if(!HasGrid(m_CrossOverSpeeds, *it) && !HasGrid(accounted, *it))
+            MarkSpeeds(**it, moved);
+    m_CrossOverSpeeds = grids;
+
+    /* same test as FastestPolar against the best and second best sampled speeds */
+    std::vector<std::vector<char> *> fastest;
+    for(int p = 0; p < polars; p++)
+        fastest.push_back(new std::vector<char>(count, 0));
+    for(int Hi = 0; Hi < crossover_Hcount; Hi++)
+        for(int VWi = 1; VWi < crossover_VWcount-1; VWi++) {
+            int c = Hi*crossover_VWcount + VWi, besti = -1;
+            float best = -INFINITY, second = -INFINITY;
+            for(int p = 0; p < polars; p++) {
+                float s = (*grids[p])[c];
+                if(s > best) {
+                    second = best;
+                    best = s;
+                    besti = p;
+                } else if(s > second)
+                    second = s;
+            }
+
+            for(int p = 0; p < polars; p++) {
+                double speed = (*grids[p])[c]*(1+Polars[p].m_crossoverpercentage);
+                float other = p == besti ? second : best;
+                (*fastest[p])[c] = !(other > speed) && speed > 0;
             }
-            bi = !bi;
         }
 
+    for(int p = 0; p < polars; p++) {
+        if(status)
+            status(arg, done++, work);
+
+        Polar &polar = Polars[p];
+        const std::vector<char> &f = *fastest[p];
+        bool regenerate = !polar.crossover_fastest || *polar.crossover_fastest != f ||
+            polar.crossover_percentage != polar.m_crossoverpercentage;
+
+        /* the boundary is refined between samples, so it can move wherever a speed
+           moved at the corners of a cell it crosses */
+        for(int Hi = 1; !regenerate && Hi < crossover_Hcount; Hi++)
+            for(int VWi = 1; VWi < crossover_VWcount; VWi++) {
+                int c0 = (Hi-1)*crossover_VWcount + VWi, c1 = c0 + crossover_VWcount;
+                if(f[c0-1] == f[c1-1] && f[c0-1] == f[c0] && f[c0-1] == f[c1])
+                    continue;
+                if(moved[c0-1] || moved[c1-1] || moved[c0] || moved[c1]) {
+                    regenerate = true;
+                    break;
+                }
+            }
+
+        polar.crossover_fastest = std::shared_ptr<const std::vector<char> >(fastest[p]);
+        polar.crossover_percentage = polar.m_crossoverpercentage;
+        if(!regenerate)
+            continue;
+
+        std::list<Segment> segments;
+        RunCrossOverThreads(p, NULL, &segments);
+
         /* insert wrapping segments for 0 and 180 */
         std::list<Segment> wrapped_segments;
         for(std::list<Segment>::iterator it = segments.begin();
@@ -263,14 +449,32 @@ void Boat::GenerateCrossOverChart(void *arg, void (*status)(void *, int, int))
         }
 
         segments.splice(segments.end(), wrapped_segments);
-        Polars[p].CrossOverRegion = PolygonRegion(segments);
-        Polars[p].CrossOverRegion.Simplify(1e-1);
-
+        polar.CrossOverRegion = PolygonRegion(segments);
+        polar.CrossOverRegion.Simplify(1e-1);
     }
     if(status)
         status(arg, Polars.size(), Polars.size());
 }
 
+/* take the chart generated on a copy of this boat, polars edited since the copy
+   only take the region and are sampled again next time */
+void Boat::MergeCrossOverChart(const Boat &generated)
+{
+    for(unsigned int i=0; i<Polars.size() && i < generated.Polars.size(); i++) {
+        Polar &polar = Polars[i];
+        const Polar &gpolar = generated.Polars[i];
+        polar.CrossOverRegion = gpolar.CrossOverRegion;
+        if(polar.FileName != gpolar.FileName || polar.speeds_version != gpolar.speeds_version)
+            continue;
+
+        polar.crossover_speeds = gpolar.crossover_speeds;
+        polar.crossover_fastest = gpolar.crossover_fastest;
+        polar.crossover_percentage = gpolar.crossover_percentage;
+        polar.crossover_version = gpolar.crossover_version;
+    }
+    m_CrossOverSpeeds = generated.m_CrossOverSpeeds;
+}
+
 Point Boat::Interp(const Point &p0, const Point &p1,
                    int q, bool q0, bool q1)
 {
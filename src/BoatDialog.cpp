@@ -995,10 +995,7 @@ void BoatDialog::OnEvtThread( wxThreadEvent & event )
     m_gCrossOverChart->Disable();
 
     m_CrossOverGenerationThread->Wait();
-    Boat &tboat = m_CrossOverGenerationThread->m_Boat;
-    for(unsigned int i=0; i<m_Boat.Polars.size() &&
-            i < tboat.Polars.size(); i++)
-        m_Boat.Polars[i].CrossOverRegion = tboat.Polars[i].CrossOverRegion;
+    m_Boat.MergeCrossOverChart(m_CrossOverGenerationThread->m_Boat);
     delete m_CrossOverGenerationThread;
     m_CrossOverGenerationThread = NULL;
     RefreshPlots();
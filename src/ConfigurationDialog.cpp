@@ -224,6 +224,9 @@ void ConfigurationDialog::SetConfigurations(std::list<RouteMapConfiguration> con
 
     SET_CHOICE_VALUE(Integrator, ((*it).Integrator == RouteMapConfiguration::RUNGE_KUTTA ?
                                   _T("Runge Kutta") : _T("Newton")));
+    SET_CHOICE_VALUE(GeodesyMode, ((*it).GeodesyMode == Geodesy::SPHERICAL ? _T("Spherical") :
+                                   (*it).GeodesyMode == Geodesy::LOCAL_TANGENT ? _T("Local Tangent") :
+                                   _T("Ellipsoidal")));
 
     SET_SPIN(MaxDivertedCourse);
     SET_SPIN(MaxCourseAngle);
@@ -239,7 +242,11 @@ void ConfigurationDialog::SetConfigurations(std::list<RouteMapConfiguration> con
     SET_CHECKBOX(AvoidCycloneTracks);
     SET_SPIN(CycloneMonths);
     SET_SPIN(CycloneDays);
+    SET_CHECKBOX(CycloneCells);
     SET_SPIN(SafetyMarginLand);
+    SET_SPIN(PrefetchDepth);
+    SET_SPIN(MaxPassageHours);
+    SET_SPIN(CorridorMiles);
 
     SET_CHECKBOX(DetectLand);
     SET_CHECKBOX(DetectBoundary);
@@ -248,6 +255,9 @@ void ConfigurationDialog::SetConfigurations(std::list<RouteMapConfiguration> con
     
     SET_CHECKBOX(InvertedRegions);
     SET_CHECKBOX(Anchoring);
+    SET_CHECKBOX(AdaptiveHeadings);
+    SET_CHECKBOX(DeferValidation);
+    SET_CHECKBOX(ShareIsochrons);
 
     SET_CHECKBOX(UseGrib);
     SET_CONTROL(ClimatologyType, m_cClimatologyType, SetSelection, int, -1);
@@ -297,15 +307,23 @@ void ConfigurationDialog::OnResetAdvanced( wxCommandEvent& event )
     m_sMaxCourseAngle->SetValue(180);
     m_sMaxSearchAngle->SetValue(120);
     m_cbAvoidCycloneTracks->SetValue(false);
+    m_cbCycloneCells->SetValue(false);
     // XXX missing 2
 
     // Options
     m_cbInvertedRegions->SetValue(false);
     m_cbAnchoring->SetValue(false);
+    m_cbAdaptiveHeadings->SetValue(false);
+    m_cbDeferValidation->SetValue(false);
+    m_cbShareIsochrons->SetValue(false);
     m_cIntegrator->SetSelection(0);
+    m_cGeodesyMode->SetSelection(0);
     m_sWindStrength->SetValue(100);
     m_sTackingTime->SetValue(0);
     m_sSafetyMarginLand->SetValue(0.);
+    m_sPrefetchDepth->SetValue(4);
+    m_sMaxPassageHours->SetValue(0);
+    m_sCorridorMiles->SetValue(0);
 
     m_sFromDegree->SetValue(0);
     m_sToDegree->SetValue(180);
@@ -428,6 +446,13 @@ void ConfigurationDialog::Update()
         else if(m_cIntegrator->GetValue() == _T("Runge Kutta"))
             configuration.Integrator = RouteMapConfiguration::RUNGE_KUTTA;
 
+        if(m_cGeodesyMode->GetValue() == _T("Ellipsoidal"))
+            configuration.GeodesyMode = Geodesy::ELLIPSOIDAL;
+        else if(m_cGeodesyMode->GetValue() == _T("Spherical"))
+            configuration.GeodesyMode = Geodesy::SPHERICAL;
+        else if(m_cGeodesyMode->GetValue() == _T("Local Tangent"))
+            configuration.GeodesyMode = Geodesy::LOCAL_TANGENT;
+
         GET_SPIN(MaxDivertedCourse);
         GET_SPIN(MaxCourseAngle);
         GET_SPIN(MaxSearchAngle);
@@ -442,7 +467,11 @@ void ConfigurationDialog::Update()
         GET_CHECKBOX(AvoidCycloneTracks);
         GET_SPIN(CycloneMonths);
         GET_SPIN(CycloneDays);
+        GET_CHECKBOX(CycloneCells);
         GET_SPIN(SafetyMarginLand);
+        GET_SPIN(PrefetchDepth);
+        GET_SPIN(MaxPassageHours);
+        GET_SPIN(CorridorMiles);
 
         GET_CHECKBOX(DetectLand);
         GET_CHECKBOX(DetectBoundary);
@@ -451,6 +480,9 @@ void ConfigurationDialog::Update()
         
         GET_CHECKBOX(InvertedRegions);
         GET_CHECKBOX(Anchoring);
+        GET_CHECKBOX(AdaptiveHeadings);
+        GET_CHECKBOX(DeferValidation);
+        GET_CHECKBOX(ShareIsochrons);
 
         GET_CHECKBOX(UseGrib);
         if(m_cClimatologyType->GetSelection() != -1)
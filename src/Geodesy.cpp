@@ -0,0 +1,94 @@
+/***************************************************************************
+ *
+ * Project:  OpenCPN Weather Routing plugin
+ * Author:   Sean D'Epagnier
+ *
+ ***************************************************************************
+ *   Copyright (C) 2016 by Sean D'Epagnier                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 3 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,  USA.         *
+ ***************************************************************************
+ */
+
+#include <math.h>
+#include <wx/wx.h>
+
+#include "Utilities.h"
+#include "Geodesy.h"
+#include "georef.h"
+
+/* mean earth radius in nautical miles */
+#define EARTH_RADIUS (6371008.8 / 1852.0)
+
+Geodesy::Geodesy(double lat, double lon, Mode mode)
+    : m_lat(lat), m_lon(lon), m_Mode(mode)
+{
+    double rlat = deg2rad(lat);
+    m_sinlat = sin(rlat);
+    m_coslat = cos(rlat);
+}
+
+void Geodesy::Destination(double brg, double dist, double *dlat, double *dlon) const
+{
+    switch(m_Mode) {
+    case SPHERICAL:
+    {
+        double rbrg = deg2rad(brg), d = dist / EARTH_RADIUS;
+        double sind = sin(d), cosd = cos(d);
+        double sinlat2 = m_sinlat*cosd + m_coslat*sind*cos(rbrg);
+        double rlat2 = asin(sinlat2);
+        double dl = atan2(sin(rbrg)*sind*m_coslat, cosd - m_sinlat*sinlat2);
+        *dlat = rad2deg(rlat2);
+        *dlon = heading_resolve(m_lon + rad2deg(dl));
+    } break;
+    case LOCAL_TANGENT:
+    {
+        double rbrg = deg2rad(brg), d = rad2deg(dist / EARTH_RADIUS);
+        *dlat = m_lat + d*cos(rbrg);
+        *dlon = heading_resolve(m_lon + d*sin(rbrg)/m_coslat);
+    } break;
+    default:
+        ll_gc_ll(m_lat, m_lon, brg, dist, dlat, dlon);
+    }
+}
+
+void Geodesy::Reverse(double lat2, double lon2, double *brg, double *dist) const
+{
+    switch(m_Mode) {
+    case SPHERICAL:
+    {
+        double rlat2 = deg2rad(lat2), dl = deg2rad(lon2 - m_lon);
+        double sinlat2 = sin(rlat2), coslat2 = cos(rlat2);
+        if(brg)
+            *brg = rad2deg(atan2(sin(dl)*coslat2, m_coslat*sinlat2 - m_sinlat*coslat2*cos(dl)));
+        if(dist) {
+            double a = sin((rlat2 - deg2rad(m_lat))/2), b = sin(dl/2);
+            double h = a*a + m_coslat*coslat2*b*b;
+            *dist = 2*EARTH_RADIUS*asin(sqrt(MIN(h, 1.0)));
+        }
+    } break;
+    case LOCAL_TANGENT:
+    {
+        double y = lat2 - m_lat, x = heading_resolve(lon2 - m_lon)*m_coslat;
+        if(brg)
+            *brg = rad2deg(atan2(x, y));
+        if(dist)
+            *dist = deg2rad(sqrt(x*x + y*y))*EARTH_RADIUS;
+    } break;
+    default:
+        ll_gc_ll_reverse(m_lat, m_lon, lat2, lon2, brg, dist);
+    }
+}
@@ -876,3 +876,141 @@ bool GribRecord::getInterpolatedValues(double &M, double &A,
     return val;
 #endif
 }
+
+//===============================================================================================
+
+GribTile::GribTile(const GribRecord *recs[FIELDS])
+    : data(NULL)
+{
+    for(int f=0; f<FIELDS; f++) {
+        records[f] = recs[f];
+        has[f] = false;
+    }
+
+    const GribRecord *ref = records[WIND_VX];
+    if(!ref || !records[WIND_VY] || !ref->ok || !ref->data || ref->Di==0 || ref->Dj==0)
+        return;
+
+    for(int f=0; f<FIELDS; f++)
+        has[f] = SameGrid(records[f]);
+
+    if(!has[WIND_VY])
+        return;
+
+    // vectors are only usable as pairs
+    if(!has[CURRENT_VX] || !has[CURRENT_VY])
+        has[CURRENT_VX] = has[CURRENT_VY] = false;
+
+    int size = ref->Ni*ref->Nj;
+    data = new float[size*FIELDS];
+    for(int k=0; k<size; k++)
+        for(int f=0; f<FIELDS; f++) {
+            double v = has[f] ? records[f]->data[k] : GRIB_NOTDEF;
+            data[k*FIELDS + f] = v == GRIB_NOTDEF ? NAN : v;
+        }
+}
+
+bool GribTile::SameGrid(const GribRecord *rec) const
+{
+    const GribRecord *ref = records[WIND_VX];
+    return rec && rec->ok && rec->data &&
+        rec->Ni == ref->Ni && rec->Nj == ref->Nj &&
+        rec->Lo1 == ref->Lo1 && rec->La1 == ref->La1 &&
+        rec->Lo2 == ref->Lo2 && rec->La2 == ref->La2 &&
+        rec->Di == ref->Di && rec->Dj == ref->Dj;
+}
+
+// same as GribRecord::getInterpolatedValue, the 3 point case is left to the record
+double GribTile::ScalarValue(int field, const float *c00, const float *c10,
+                             const float *c01, const float *c11,
+                             double dx, double dy, double px, double py) const
+{
+    double x00 = c00[field], x10 = c10[field], x01 = c01[field], x11 = c11[field];
+    if(std::isnan(x00) || std::isnan(x10) || std::isnan(x01) || std::isnan(x11))
+        return records[field]->getInterpolatedValue(px, py, true);
+
+    double x1 = (1.0-dx)*x00 + dx*x10;
+    double x2 = (1.0-dx)*x01 + dx*x11;
+    return (1.0-dy)*x1 + dy*x2;
+}
+
+// same as GribRecord::getInterpolatedValues
+bool GribTile::VectorValue(int fieldx, const float *c00, const float *c10,
+                           const float *c01, const float *c11,
+                           double dx, double dy, double &M, double &A) const
+{
+    int fieldy = fieldx + 1;
+    double x00x = c00[fieldx], x00y = c00[fieldy];
+    double x01x = c01[fieldx], x01y = c01[fieldy];
+    double x10x = c10[fieldx], x10y = c10[fieldy];
+    double x11x = c11[fieldx], x11y = c11[fieldy];
+
+    if(std::isnan(x00x) || std::isnan(x00y) || std::isnan(x01x) || std::isnan(x01y) ||
+       std::isnan(x10x) || std::isnan(x10y) || std::isnan(x11x) || std::isnan(x11y))
+        return false;
+
+    double x00m = sqrt(x00x*x00x + x00y*x00y), x00a = atan2(x00x, x00y);
+    double x01m = sqrt(x01x*x01x + x01y*x01y), x01a = atan2(x01x, x01y);
+    double x10m = sqrt(x10x*x10x + x10y*x10y), x10a = atan2(x10x, x10y);
+    double x11m = sqrt(x11x*x11x + x11y*x11y), x11a = atan2(x11x, x11y);
+
+    double x0m = (1-dx)*x00m + dx*x10m, x0a = interp_angle(x00a, x10a, dx, M_PI);
+    double x1m = (1-dx)*x01m + dx*x11m, x1a = interp_angle(x01a, x11a, dx, M_PI);
+
+    M = (1-dy)*x0m + dy*x1m;
+    A = interp_angle(x0a, x1a, dy, M_PI);
+    A *= 180 / M_PI; // degrees
+    A += 180;
+    return true;
+}
+
+void GribTile::SampleAll(double px, double py, GribTileSample &sample) const
+{
+    sample.has_current = has[CURRENT_VX];
+    sample.has_swell = has[HTSIGW];
+    sample.has_gust = has[WIND_GUST];
+    sample.wind = sample.current = false;
+    sample.swell = sample.gust = GRIB_NOTDEF;
+
+    const GribRecord *ref = records[WIND_VX];
+    double opx = px;
+    if (!ref->isPointInMap(px,py)) {
+        px += 360.0;
+        if (!ref->isPointInMap(px,py)) {
+            px -= 2*360.0;
+            if (!ref->isPointInMap(px,py))
+                return;
+        }
+    }
+
+    double pi = (px-ref->Lo1)/ref->Di;
+    double pj = (py-ref->La1)/ref->Dj;
+
+    int i0 = (int) pi;
+    int j0 = (int) pj;
+
+    unsigned int i1 = pi+1, j1 = pj+1;
+    if(i1 >= ref->Ni)
+        i1 = i0;
+
+    if(j1 >= ref->Nj)
+        j1 = j0;
+
+    double dx = pi-i0;
+    double dy = pj-j0;
+
+    dx = (3.0 - 2.0*dx)*dx*dx;   // pseudo hermite interpolation
+    dy = (3.0 - 2.0*dy)*dy*dy;
+
+    int Ni = ref->Ni;
+    const float *c00 = data + (j0*Ni + i0)*FIELDS, *c10 = data + (j0*Ni + i1)*FIELDS;
+    const float *c01 = data + (j1*Ni + i0)*FIELDS, *c11 = data + (j1*Ni + i1)*FIELDS;
+
+    sample.wind = VectorValue(WIND_VX, c00, c10, c01, c11, dx, dy, sample.VW, sample.W);
+    if(has[CURRENT_VX])
+        sample.current = VectorValue(CURRENT_VX, c00, c10, c01, c11, dx, dy, sample.VC, sample.C);
+    if(has[HTSIGW])
+        sample.swell = ScalarValue(HTSIGW, c00, c10, c01, c11, dx, dy, opx, py);
+    if(has[WIND_GUST])
+        sample.gust = ScalarValue(WIND_GUST, c00, c10, c01, c11, dx, dy, opx, py);
+}
@@ -178,6 +178,8 @@ double Polar::VelocityTrueWind2(double VA, double VB, double A)
 }
 
 Polar::Polar()
+    : dense_VW0(0), dense_VW_step(0), dense_VW_count(0), max_speed(0),
+      crossover_percentage(0), speeds_version(0), crossover_version(0)
 {
     m_crossoverpercentage = 0;
 }
@@ -439,8 +441,15 @@ void Polar::OptimizeTackingSpeed()
 }
 #endif
 
+/* fastest speed in the table, Speed never exceeds it when bound,
+   kept by UpdateDenseSpeeds which follows every change of the speeds */
+double Polar::MaxSpeed() const
+{
+    return max_speed;
+}
+
 // return index of wind speed in table which less than our wind speed
-void Polar::ClosestVWi(double VW, int &VW1i, int &VW2i)
+void Polar::ClosestVWi(double VW, int &VW1i, int &VW2i) const
 {
     for(unsigned int VWi = 1; VWi < wind_speeds.size()-1; VWi++)
         if(wind_speeds[VWi].VW > VW) {
@@ -454,7 +463,7 @@ void Polar::ClosestVWi(double VW, int &VW1i, int &VW2i)
 }
 
 
-bool Polar::VMGAngle(SailingWindSpeed &ws1, SailingWindSpeed &ws2, float VW, float &W)
+bool Polar::VMGAngle(const SailingWindSpeed &ws1, const SailingWindSpeed &ws2, float VW, float &W) const
 {
     // optimization
     SailingVMG vmg1 = ws1.VMG, vmg2 = ws2.VMG;
@@ -483,7 +492,7 @@ bool Polar::VMGAngle(SailingWindSpeed &ws1, SailingWindSpeed &ws2, float VW, flo
 
 /* compute boat speed from true wind angle and true wind speed
  */
-double Polar::Speed(double W, double VW, bool bound, bool optimize_tacking)
+double Polar::Speed(double W, double VW, bool bound, bool optimize_tacking) const
 {
     if(VW < 0)
         return NAN;
@@ -503,6 +512,12 @@ double Polar::Speed(double W, double VW, bool bound, bool optimize_tacking)
     if(bound && (VW < wind_speeds[0].VW || VW > wind_speeds[wind_speeds.size()-1].VW))
         return NAN;
 
+    if(dense_VW_count) {
+        double VB = DenseSpeed(W, VW, optimize_tacking);
+        if(!std::isnan(VB))
+            return VB;
+    }
+
     unsigned int W1i = degree_step_index[(int)floor(W)];
     unsigned int W2i = W1i +1;
     if (W2i > degree_steps.size() - 1)
@@ -513,7 +528,7 @@ double Polar::Speed(double W, double VW, bool bound, bool optimize_tacking)
 
     int VW1i, VW2i;
     ClosestVWi(VW, VW1i, VW2i);
-    SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
+    const SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
 
     if(optimize_tacking) {
         float vmgW = W;
@@ -613,12 +628,12 @@ double Polar::SpeedAtApparentWind(double A, double VA, double *pW)
     }
 }
 
-SailingVMG Polar::GetVMGTrueWind(double VW)
+SailingVMG Polar::GetVMGTrueWind(double VW) const
 {
     int VW1i, VW2i;
     ClosestVWi(VW, VW1i, VW2i);
 
-    SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
+    const SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
     double VW1 = ws1.VW, VW2 = ws2.VW;
     SailingVMG vmg, vmg1 = ws1.VMG, vmg2 = ws2.VMG;
 
@@ -776,6 +791,10 @@ bool Polar::InterpolateSpeeds()
 
 void Polar::UpdateSpeeds()
 {
+    // the vmg must be computed from the polar, not the old table
+    dense_speeds.clear();
+    dense_VW_count = 0;
+
     // interpolate wind speeds
     for(unsigned int i=0; i<wind_speeds.size(); i++) {
         wind_speeds[i].speeds.clear();
@@ -802,6 +821,79 @@ void Polar::UpdateSpeeds()
 
     for(unsigned int VWi = 0; VWi < wind_speeds.size(); VWi++)
         CalculateVMG(VWi);
+
+    UpdateDenseSpeeds();
+}
+
+/* sample Speed on a fine grid, the table is cleared first so the
+   samples come from the polar itself */
+void Polar::UpdateDenseSpeeds()
+{
+    speeds_version++;
+
+    max_speed = 0;
+    for(unsigned int VWi = 0; VWi < wind_speeds.size(); VWi++) {
+        std::vector<float> &speeds = wind_speeds[VWi].speeds;
+        for(unsigned int Wi = 0; Wi < speeds.size(); Wi++)
+            if(speeds[Wi] > max_speed)
+                max_speed = speeds[Wi];
+    }
+
+    dense_speeds.clear();
+    dense_VW_count = 0;
+
+    if(!degree_steps.size() || wind_speeds.size() < 2)
+        return;
+
+    dense_VW0 = wind_speeds[0].VW;
+    double range = wind_speeds[wind_speeds.size()-1].VW - dense_VW0;
+    int steps = ceil(range / DENSE_WIND_STEP);
+    if(steps < 1 || steps > DENSE_MAX_WIND_STEPS)
+        return;
+
+    dense_VW_step = range / steps;
+    int W_count = 180 / DENSE_DEGREE_STEP + 1;
+    std::vector<float> speeds;
+    speeds.reserve(2*W_count*(steps+1));
+    for(int VWi = 0; VWi <= steps; VWi++) {
+        double VW = dense_VW0 + VWi*dense_VW_step;
+        for(int Wi = 0; Wi < W_count; Wi++) {
+            double W = Wi*DENSE_DEGREE_STEP;
+            speeds.push_back(Speed(W, VW, true, false));
+            speeds.push_back(Speed(W, VW, true, true));
+        }
+    }
+
+    dense_speeds = speeds;
+    dense_VW_count = steps+1;
+}
+
+/* W is 0 to 180, NAN if outside the table or next to an invalid speed */
+double Polar::DenseSpeed(double W, double VW, bool optimize_tacking) const
+{
+    double VWp = (VW - dense_VW0) / dense_VW_step, Wp = W / DENSE_DEGREE_STEP;
+    int VWi = floor(VWp), Wi = floor(Wp);
+    /* above the top wind speed the polar extrapolates, the table would clamp */
+    if(VWi < 0 || VWp > dense_VW_count-1)
+        return NAN;
+
+    const int W_count = 180 / DENSE_DEGREE_STEP + 1;
+    int VWi2 = VWi < dense_VW_count-1 ? VWi+1 : VWi;
+    int Wi2 = Wi < W_count-1 ? Wi+1 : Wi;
+    double dVW = VWp - VWi, dW = Wp - Wi;
+
+    const float *s1 = &dense_speeds[2*VWi*W_count] + optimize_tacking;
+    const float *s2 = &dense_speeds[2*VWi2*W_count] + optimize_tacking;
+    float VB11 = s1[2*Wi], VB12 = s1[2*Wi2], VB21 = s2[2*Wi], VB22 = s2[2*Wi2];
+
+    /* the polar is not smooth here (tacking angle, or edge of the polar) */
+    if(fabsf(VB11 - VB12) > DENSE_MAX_SPREAD || fabsf(VB21 - VB22) > DENSE_MAX_SPREAD ||
+       fabsf(VB11 - VB21) > DENSE_MAX_SPREAD || fabsf(VB12 - VB22) > DENSE_MAX_SPREAD)
+        return NAN;
+
+    double VB1 = (1-dW)*VB11 + dW*VB12;
+    double VB2 = (1-dW)*VB21 + dW*VB22;
+    return (1-dVW)*VB1 + dVW*VB2;
 }
 
 void Polar::UpdateDegreeStepLookup()
@@ -819,12 +911,12 @@ void Polar::UpdateDegreeStepLookup()
 }
 
 // Determine if our current state is satisfied by the current cross over contour
-bool Polar::InsideCrossOverContour(float H, float VW, bool optimize_tacking)
+bool Polar::InsideCrossOverContour(float H, float VW, bool optimize_tacking) const
 {
     if(optimize_tacking) {
         int VW1i, VW2i;
         ClosestVWi(VW, VW1i, VW2i);
-        SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
+        const SailingWindSpeed &ws1 = wind_speeds[VW1i], &ws2 = wind_speeds[VW2i];
         VMGAngle(ws1, ws2, VW, H);
     }
     // rounding error, XXX what about overlapping ?
@@ -1005,6 +1097,8 @@ void Polar::Generate(const std::list<PolarMeasurement> &measurements)
             wind_speeds[VWi].speeds[Wi] = BoatSpeedFromMeasurements(measurements, W, VW);
         }
     }
+
+    UpdateDenseSpeeds();
 }
 
 void Polar::CalculateVMG(int VWi)
@@ -247,10 +247,10 @@ std::string PolygonRegion::toString()
     return str;
 }
 
-bool PolygonRegion::Contains(float x, float y)
+bool PolygonRegion::Contains(float x, float y) const
 {
     int total = 0;
-    for(std::list<Contour>::iterator it = contours.begin();
+    for(std::list<Contour>::const_iterator it = contours.begin();
         it != contours.end(); it++) {
         unsigned int l = it->n-1;
         float xl = it->points[2*l+0], yl = it->points[2*l+1];
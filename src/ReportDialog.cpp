@@ -172,231 +172,292 @@ wxString ReportDialog::FormatTime(wxDateTime t)
     return r;
 }
 
-void ReportDialog::GenerateRoutesReport()
+/* group key of a route */
+static wxString RouteString(RouteMapOverlay *routemapoverlay)
 {
-    if(!m_bReportStale)
-        return;
-    m_bReportStale = false;
+    RouteMapConfiguration c = routemapoverlay->GetConfiguration();
+    return c.Start + _T(" - ") + c.End;
+}
+
+/* a route finished computing, only its group needs to be redone */
+void ReportDialog::RouteFinished(RouteMapOverlay *routemapoverlay)
+{
+    /* the configuration may have moved it to another group */
+    for(std::map<wxString, RouteGroup>::iterator it = m_RouteGroups.begin(); it != m_RouteGroups.end(); it++)
+        for(std::list<ReportedRoute>::iterator it2 = it->second.routes.begin();
+            it2 != it->second.routes.end(); it2++)
+            if(it2->routemapoverlay == routemapoverlay) {
+                it->second.routes.erase(it2);
+                it->second.stale = true;
+                break;
+            }
 
-    /* sort configurations interate over each group of configurations
-       with the same start and end to determine best and worst times,
-       and cyclone crossings to determine cyclone times
-    */
+    if(routemapoverlay->ReachedDestination())
+        AddRoute(routemapoverlay);
+}
 
-    std::map<wxString, std::list<RouteMapOverlay *> > routes;
-    for(std::list<WeatherRoute*>::iterator it = m_WeatherRouting.m_WeatherRoutes.begin();
-        it != m_WeatherRouting.m_WeatherRoutes.end(); it++) {
-        if(!(*it)->routemapoverlay->ReachedDestination())
-            continue;
-        wxString route_string = (*it)->Start + _T(" - ") + (*it)->End;
-        std::list<RouteMapOverlay *> overlays = routes[route_string];
-        overlays.push_back((*it)->routemapoverlay);
-        routes[route_string] = overlays;
+void ReportDialog::AddRoute(RouteMapOverlay *routemapoverlay)
+{
+    RouteGroup &group = m_RouteGroups[RouteString(routemapoverlay)];
+    wxDateTime start = routemapoverlay->StartTime();
+    std::list<ReportedRoute>::iterator it = group.routes.begin();
+    while(it != group.routes.end() && it->routemapoverlay->StartTime() <= start)
+        it++;
+    group.routes.insert(it, ReportedRoute(routemapoverlay));
+    group.stale = true;
+}
+
+void ReportDialog::GenerateRoutesReport()
+{
+    bool changed = false;
+    if(m_bReportStale) {
+        m_bReportStale = false;
+        m_RouteGroups.clear();
+        for(std::list<WeatherRoute*>::iterator it = m_WeatherRouting.m_WeatherRoutes.begin();
+            it != m_WeatherRouting.m_WeatherRoutes.end(); it++)
+            if((*it)->routemapoverlay->ReachedDestination())
+                AddRoute((*it)->routemapoverlay);
+        changed = true;
     }
 
-    if(routes.size() == 0) {
+    for(std::map<wxString, RouteGroup>::iterator it = m_RouteGroups.begin(); it != m_RouteGroups.end(); ) {
+        RouteGroup &group = it->second;
+        if(group.stale) {
+            GenerateGroupReport(group);
+            changed = true;
+        }
+        if(group.routes.empty())
+            m_RouteGroups.erase(it++);
+        else
+            it++;
+    }
+
+    if(!changed)
+        return;
+
+    if(m_RouteGroups.size() == 0) {
         m_htmlRoutesReport->SetPage(_("No routes to report yet."));
         return;
     }
 
     wxString page;
-    for(std::map<wxString, std::list<RouteMapOverlay *> >::iterator it = routes.begin();
-                          it != routes.end(); it++)
-    {
-        std::list<RouteMapOverlay *> overlays = it->second;
-        if (overlays.begin() == overlays.end()) {
-            // XXX not possible? but shut up compilers warnings
-            continue;
-        }
-        RouteMapOverlay *first = *overlays.begin();
+    for(std::map<wxString, RouteGroup>::iterator it = m_RouteGroups.begin(); it != m_RouteGroups.end(); it++)
+        page += it->second.page;
+    m_htmlRoutesReport->SetPage(page);
+}
 
-        RouteMapConfiguration c = first->GetConfiguration();
-        page += _T("<p>");
-        page += c.Start + _T(" ") + _("to") + _T(" ") + c.End + _T(" ") + wxString::Format
-            (_T("(%ld ") + wxString(_("configurations")) + _T(")\n"), overlays.size());
-
-        /* determine fastest time */
-        wxTimeSpan fastest_time;
-        RouteMapOverlay *fastest;
-
-        std::multimap< wxDateTime, RouteMapOverlay * > sort_by_start;
-        bool any_bad = false;
-        bool any_good = false;
-
-        for(std::list<RouteMapOverlay *>::iterator it2 = overlays.begin(); it2 != overlays.end(); it2++) {
-            RouteMapOverlay *r = *it2;
-            wxTimeSpan current_time = r->EndTime() - r->StartTime();
-            sort_by_start.insert(std::pair< wxDateTime, RouteMapOverlay * >(r->StartTime() , r));
-            if(r == first || current_time < fastest_time) {
-                fastest_time = current_time;
-                fastest = r;
-            }
-            if (r->RouteInfo(RouteMapOverlay::PERCENTAGE_UPWIND) > 50) {
-                any_bad = true;
-            } else {
-                any_good = true;
-            }
-        }
+/* sort configurations interate over each group of configurations
+   with the same start and end to determine best and worst times,
+   and cyclone crossings to determine cyclone times
+*/
+void ReportDialog::GenerateGroupReport(RouteGroup &group)
+{
+    group.stale = false;
+    group.page = wxEmptyString;
+
+    /* read values of routes new to the group, dropping routes being recomputed */
+    int newroutes = 0;
+    for(std::list<ReportedRoute>::iterator it = group.routes.begin(); it != group.routes.end(); ) {
+        if(!it->routemapoverlay->ReachedDestination())
+            it = group.routes.erase(it);
+        else
+            newroutes += !(it++)->computed;
+    }
 
-        page += _("<dt>Fastest configuration ") + FormatTime(fastest->StartTime());
-        page += wxString(_T(" ")) + _("avg speed") + wxString::Format
-            (_T(": %.2f "), fastest->RouteInfo(RouteMapOverlay::AVGSPEED))
-	    + _("knots");
-
-        /* determine best times if upwind percentage is below 50 */
-        page += _T("<dt>");
-        page += _("Best Times (mostly downwind)") + wxString(_T(": "));
-        if (any_good == false) {
-            // no downwind route
-            page += _("none");
-        }
-        else if (any_bad == false) {
-            // all routes are downwind
-            page += _("any");
+    if(group.routes.empty())
+        return;
+
+    if(newroutes) {
+        wxProgressDialog progressdialog(_("Weather Routing"), _("Calculating Cyclone Crossings"),
+                                        newroutes, this, wxPD_ELAPSED_TIME);
+        int pdi = 0;
+        for(std::list<ReportedRoute>::iterator it = group.routes.begin(); it != group.routes.end(); it++) {
+            if(it->computed)
+                continue;
+            RouteMapOverlay *r = it->routemapoverlay;
+            it->start = r->StartTime();
+            it->end = r->EndTime();
+            it->avgspeed = r->RouteInfo(RouteMapOverlay::AVGSPEED);
+            it->upwind = r->RouteInfo(RouteMapOverlay::PERCENTAGE_UPWIND);
+            it->comfort = r->RouteInfo(RouteMapOverlay::COMFORT);
+            for(int i=0; i<12; i++)
+                it->cyclonemonths[i] = 0;
+            it->cyclones = r->Cyclones(it->cyclonemonths);
+            it->computed = true;
+            progressdialog.Update(pdi++);
         }
-        else {
-            bool first_print = true;
-            std::multimap< wxDateTime, RouteMapOverlay * > reduce_by_start;
-            // merge downwind routes in bigger interval
-            // assume most routes with same start time are of same kind (downwind or upwind)
-            std::multimap< wxDateTime, RouteMapOverlay * >::iterator it = sort_by_start.begin();
-            while (it != sort_by_start.end() ) {
-                // remove first upwind routes, from any_good test there's at least one downwind route
-                for(; it != sort_by_start.end(); it++) {
-                    RouteMapOverlay *r = it->second;
-                    if (r->RouteInfo(RouteMapOverlay::PERCENTAGE_UPWIND) <= 50) {
-                        break;
-                     }
-                }
-                if (it == sort_by_start.end()) 
-                    break;
+    }
 
-                RouteMapOverlay *r = it->second;
-                wxDateTime s = DisplayedTime(r->StartTime());
-                wxDateTime e = DisplayedTime(r->EndTime());
-                // merge downwind
-                for(; it != sort_by_start.end(); it++) {
-                    RouteMapOverlay *r = it->second;
-                    if (r->RouteInfo(RouteMapOverlay::PERCENTAGE_UPWIND) > 50) {
-                        break;
-                    }
-                    e = r->EndTime();
-                }
-                if(first_print)
-                    first_print = false;
-                else
-                    page += _(" and ");
-                page += s.Format(_T("%d %B ")) + _("to") + e.Format(_T(" %d %B"));
-            }
+    std::list<ReportedRoute> &routes = group.routes;
+    wxString &page = group.page;
+
+    RouteMapConfiguration c = routes.front().routemapoverlay->GetConfiguration();
+    page += _T("<p>");
+    page += c.Start + _T(" ") + _("to") + _T(" ") + c.End + _T(" ") + wxString::Format
+        (_T("(%ld ") + wxString(_("configurations")) + _T(")\n"), routes.size());
+
+    /* determine fastest time */
+    wxTimeSpan fastest_time;
+    ReportedRoute *fastest = NULL;
+
+    bool any_bad = false;
+    bool any_good = false;
+
+    for(std::list<ReportedRoute>::iterator it = routes.begin(); it != routes.end(); it++) {
+        wxTimeSpan current_time = it->end - it->start;
+        if(!fastest || current_time < fastest_time) {
+            fastest_time = current_time;
+            fastest = &*it;
         }
-        
-        // CUSTOMIZATION
-        // Display the best option to travel in order
-        // to get the most comfortable sailing
-        page += _T("<dt>");
-        page += _("Best Sailing Comfort") + wxString(_T(": "));
-        wxDateTime best_comfort_date;
-        int best_sailing_comfort = 6;
-        for(std::multimap< wxDateTime, RouteMapOverlay * >::iterator it3 = sort_by_start.begin(); it3 != sort_by_start.end(); it3++) {
-            RouteMapOverlay *r = it3->second;
-            if (!best_comfort_date.IsValid() ||
-                (best_comfort_date < r->StartTime() && best_sailing_comfort > r->RouteInfo(RouteMapOverlay::COMFORT)))
-            {
-                best_comfort_date = r->StartTime();
-                best_sailing_comfort = r->RouteInfo(RouteMapOverlay::COMFORT);
-            }
+        if (it->upwind > 50) {
+            any_bad = true;
+        } else {
+            any_good = true;
         }
-        page += RouteMapOverlay::sailingConditionText(best_sailing_comfort);
-        page += _T(" on ");
-        page += FormatTime(best_comfort_date);
-        
-        page += _T("<dt>");
-        page += _("Cyclones") + wxString(_T(": "));
+    }
 
-        wxProgressDialog progressdialog(_("Weather Routing"), _("Calculating Cyclone Crossings"),
-                                        overlays.size(), this, wxPD_ELAPSED_TIME);
-        int pdi = 0;
+    page += _("<dt>Fastest configuration ") + FormatTime(fastest->start);
+    page += wxString(_T(" ")) + _("avg speed") + wxString::Format
+        (_T(": %.2f "), fastest->avgspeed) + _("knots");
 
-        int cyclonemonths[12] = {0};
-        std::list<RouteMapOverlay *> cyclone_safe_routes;
-        bool allsafe = true, nonesafe = true;
-        for(std::list<RouteMapOverlay *>::iterator it2 = overlays.begin(); it2 != overlays.end(); it2++) {
-            switch((*it2)->Cyclones(cyclonemonths)) {
-            case -1:
-                page += _("Climatology data unavailable.");
-                goto cyclonesfailed;
-            case 0:
-                cyclone_safe_routes.push_back(*it2);
-                nonesafe = false;
-            default:
-                cyclone_safe_routes.push_back(NULL);
-                allsafe = false;
+    /* determine best times if upwind percentage is below 50 */
+    page += _T("<dt>");
+    page += _("Best Times (mostly downwind)") + wxString(_T(": "));
+    if (any_good == false) {
+        // no downwind route
+        page += _("none");
+    }
+    else if (any_bad == false) {
+        // all routes are downwind
+        page += _("any");
+    }
+    else {
+        bool first_print = true;
+        // merge downwind routes in bigger interval
+        // assume most routes with same start time are of same kind (downwind or upwind)
+        std::list<ReportedRoute>::iterator it = routes.begin();
+        while (it != routes.end() ) {
+            // remove first upwind routes, from any_good test there's at least one downwind route
+            for(; it != routes.end(); it++)
+                if (it->upwind <= 50)
+                    break;
+            if (it == routes.end())
+                break;
+
+            wxDateTime s = DisplayedTime(it->start);
+            wxDateTime e = DisplayedTime(it->end);
+            // merge downwind
+            for(; it != routes.end(); it++) {
+                if (it->upwind > 50)
+                    break;
+                e = it->end;
             }
-
-            progressdialog.Update(pdi++);
+            if(first_print)
+                first_print = false;
+            else
+                page += _(" and ");
+            page += s.Format(_T("%d %B ")) + _("to") + e.Format(_T(" %d %B"));
         }
-        
-        int i, j;
-        for(i=0, j=11; i<12; j=i++)
-            /* get first cyclone month */
-            if(cyclonemonths[i] && !cyclonemonths[j]) {
-                int lm = i;
-                page += wxDateTime::GetMonthName((wxDateTime::Month)i);
-                for(int k=i+1, l=i; ; l = k++) {
-                    if(k==12) k = 0;
-                    if(k == i)
-                        break;
-                    if(cyclonemonths[k] && !cyclonemonths[l]) {
-                        page += _(" and ") + wxDateTime::GetMonthName((wxDateTime::Month)k);
-                        lm = k;
-                    } else if(!cyclonemonths[k] && cyclonemonths[l] && l!=lm)
-                        page += _(" to ") + wxDateTime::GetMonthName((wxDateTime::Month)l);
-                }
-                goto had_some_cyclones;
-            }
-                    
-        if(cyclonemonths[0])
-            page += _("all months");
-        else
-            page += _("none");
-
-    had_some_cyclones:;
-
-        page += _T("<dt>");
-        if(allsafe)
-            page += _("All routes are safe from cyclones.");
-        else if(nonesafe)
-            page += _("No routes found to be safe from cyclones.");
-        else {
-            page += _("Start times for cyclone safe routes: ");
-            /* note: does not merge beginning and end of linked list for safe times,
-               this sometimes might be nice, but they will be in different years. */
-            bool first = true;
-            for(std::list<RouteMapOverlay *>::iterator it2 = cyclone_safe_routes.begin(); it2 != cyclone_safe_routes.end();
-                        it2++)
-            {
-                if(!*it2) continue;
-                if(!first)
-                    page += _(" and ");
-                first = false;
-                page += DisplayedTime((*it2)->StartTime()).Format(_T("%x"));
-
-                if(++it2 == cyclone_safe_routes.end())
-                    break;
-
-                if(!*it2)
-                    continue;
+    }
 
-                while(*it2 && ++it2 != cyclone_safe_routes.end());
+    // CUSTOMIZATION
+    // Display the best option to travel in order
+    // to get the most comfortable sailing
+    page += _T("<dt>");
+    page += _("Best Sailing Comfort") + wxString(_T(": "));
+    wxDateTime best_comfort_date;
+    int best_sailing_comfort = 6;
+    for(std::list<ReportedRoute>::iterator it = routes.begin(); it != routes.end(); it++) {
+        if (!best_comfort_date.IsValid() ||
+            (best_comfort_date < it->start && best_sailing_comfort > it->comfort))
+        {
+            best_comfort_date = it->start;
+            best_sailing_comfort = it->comfort;
+        }
+    }
+    page += RouteMapOverlay::sailingConditionText(best_sailing_comfort);
+    page += _T(" on ");
+    page += FormatTime(best_comfort_date);
+
+    page += _T("<dt>");
+    page += _("Cyclones") + wxString(_T(": "));
+
+    int cyclonemonths[12] = {0};
+    std::list<ReportedRoute *> cyclone_safe_routes;
+    bool allsafe = true, nonesafe = true;
+    for(std::list<ReportedRoute>::iterator it = routes.begin(); it != routes.end(); it++) {
+        for(int i=0; i<12; i++)
+            cyclonemonths[i] += it->cyclonemonths[i];
+        switch(it->cyclones) {
+        case -1:
+            page += _("Climatology data unavailable.");
+            return;
+        case 0:
+            cyclone_safe_routes.push_back(&*it);
+            nonesafe = false;
+        default:
+            cyclone_safe_routes.push_back(NULL);
+            allsafe = false;
+        }
+    }
 
-                it2--;
-                page += _(" to ") + DisplayedTime((*it2)->StartTime()).Format(_T("%x"));
+    int i, j;
+    for(i=0, j=11; i<12; j=i++)
+        /* get first cyclone month */
+        if(cyclonemonths[i] && !cyclonemonths[j]) {
+            int lm = i;
+            page += wxDateTime::GetMonthName((wxDateTime::Month)i);
+            for(int k=i+1, l=i; ; l = k++) {
+                if(k==12) k = 0;
+                if(k == i)
+                    break;
+                if(cyclonemonths[k] && !cyclonemonths[l]) {
+                    page += _(" and ") + wxDateTime::GetMonthName((wxDateTime::Month)k);
+                    lm = k;
+                } else if(!cyclonemonths[k] && cyclonemonths[l] && l!=lm)
+                    page += _(" to ") + wxDateTime::GetMonthName((wxDateTime::Month)l);
             }
+            goto had_some_cyclones;
         }
-    cyclonesfailed:;
-    }
 
-    m_htmlRoutesReport->SetPage(page);
+    if(cyclonemonths[0])
+        page += _("all months");
+    else
+        page += _("none");
+
+had_some_cyclones:;
+
+    page += _T("<dt>");
+    if(allsafe)
+        page += _("All routes are safe from cyclones.");
+    else if(nonesafe)
+        page += _("No routes found to be safe from cyclones.");
+    else {
+        page += _("Start times for cyclone safe routes: ");
+        /* note: does not merge beginning and end of linked list for safe times,
+           this sometimes might be nice, but they will be in different years. */
+        bool first = true;
+        for(std::list<ReportedRoute *>::iterator it2 = cyclone_safe_routes.begin(); it2 != cyclone_safe_routes.end();
+            it2++)
+        {
+            if(!*it2) continue;
+            if(!first)
+                page += _(" and ");
+            first = false;
+            page += DisplayedTime((*it2)->start).Format(_T("%x"));
+
+            if(++it2 == cyclone_safe_routes.end())
+                break;
+
+            if(!*it2)
+                continue;
+
+            while(*it2 && ++it2 != cyclone_safe_routes.end());
+
+            it2--;
+            page += _(" to ") + DisplayedTime((*it2)->start).Format(_T("%x"));
+        }
+    }
 }
 
 void ReportDialog::OnInformation( wxCommandEvent& event )
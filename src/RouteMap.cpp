@@ -71,6 +71,8 @@
 #include <stdlib.h>
 #include <math.h>
 #include <map>
+#include <set>
+#include <algorithm>
 
 #include "Utilities.h"
 #include "Boat.h"
@@ -81,6 +83,12 @@
 
 #define distance(X, Y) sqrt((X)*(X) + (Y)*(Y)) // much faster than hypot
 
+/* fraction of the corridor range at which the best position widens it */
+#define CORRIDOR_EDGE .75
+
+/* adaptive headings first sail every this many of the configured headings */
+#define ADAPTIVE_HEADING_STRIDE 4
+
 long RouteMapPosition::s_ID = 0;
 
 extern Json::Value g_ReceivedJSONMsg;
@@ -117,7 +125,21 @@ static Json::Value RequestGRIB(const wxDateTime &t, const wxString &what, double
     return error;
 }
 
-static double Swell(RouteMapConfiguration &configuration, double lat, double lon)
+/* interpolate all the grib fields at once from the interleaved tile,
+   returns NULL if the grib records must be read individually */
+static inline const GribTileSample *SampleGrib(RouteMapConfiguration &configuration,
+                                               double lat, double lon, GribTileSample &sample)
+{
+    WR_GribRecordSet *grib = configuration.grib;
+    if(!grib || !grib->m_Tile)
+        return NULL;
+
+    grib->m_Tile->SampleAll(lon, lat, sample);
+    return &sample;
+}
+
+static double Swell(RouteMapConfiguration &configuration, double lat, double lon,
+                    const GribTileSample *sample = NULL)
 {
     WR_GribRecordSet *grib = configuration.grib;
 
@@ -131,11 +153,16 @@ static double Swell(RouteMapConfiguration &configuration, double lat, double lon
     if(!grib)
         return 0;
 
-    GribRecord *grh = grib->m_GribRecordPtrArray[Idx_HTSIGW];
-    if(!grh)
-        return 0;
+    double height;
+    if(sample && sample->has_swell)
+        height = sample->swell;
+    else {
+        GribRecord *grh = grib->m_GribRecordPtrArray[Idx_HTSIGW];
+        if(!grh)
+            return 0;
 
-    double height = grh->getInterpolatedValue(lon, lat, true );
+        height = grh->getInterpolatedValue(lon, lat, true );
+    }
     if(height == GRIB_NOTDEF)
         return 0;
     // yep swell data can be negative!
@@ -144,7 +171,8 @@ static double Swell(RouteMapConfiguration &configuration, double lat, double lon
     return height;
 }
 
-static double Gust(RouteMapConfiguration &configuration, double lat, double lon)
+static double Gust(RouteMapConfiguration &configuration, double lat, double lon,
+                   const GribTileSample *sample = NULL)
 {
     WR_GribRecordSet *grib = configuration.grib;
     double gust;
@@ -157,6 +185,8 @@ static double Gust(RouteMapConfiguration &configuration, double lat, double lon)
     }
     else if(!grib)
         return NAN;
+    else if(sample && sample->has_gust)
+        gust = sample->gust;
     else {
         GribRecord *grh = grib->m_GribRecordPtrArray[Idx_WIND_GUST];
         if(!grh)
@@ -172,7 +202,7 @@ static double Gust(RouteMapConfiguration &configuration, double lat, double lon)
 
 
 static bool GribWind(RouteMapConfiguration &configuration, double lat, double lon,
-                            double &WG, double &VWG)
+                            double &WG, double &VWG, const GribTileSample *sample = NULL)
 {
     WR_GribRecordSet *grib = configuration.grib;
 
@@ -189,6 +219,13 @@ static bool GribWind(RouteMapConfiguration &configuration, double lat, double lo
     else if(!grib)
         return false;
 
+    else if(sample) {
+        if(!sample->wind)
+            return false;
+        VWG = sample->VW;
+        WG = sample->W;
+    }
+
     else if(!GribRecord::getInterpolatedValues(VWG, WG,
                                           grib->m_GribRecordPtrArray[Idx_WIND_VX],
                                           grib->m_GribRecordPtrArray[Idx_WIND_VY], lon, lat))
@@ -206,7 +243,7 @@ static bool GribWind(RouteMapConfiguration &configuration, double lat, double lo
 enum {WIND, CURRENT};
 
 static bool GribCurrent(RouteMapConfiguration &configuration, double lat, double lon,
-                               double &C, double &VC)
+                               double &C, double &VC, const GribTileSample *sample = NULL)
 {
     WR_GribRecordSet *grib = configuration.grib;
 
@@ -223,6 +260,13 @@ static bool GribCurrent(RouteMapConfiguration &configuration, double lat, double
     else if(!grib)
         return false;
 
+    else if(sample && sample->has_current) {
+        if(!sample->current)
+            return false;
+        VC = sample->VC;
+        C = sample->C;
+    }
+
     else if(!GribRecord::getInterpolatedValues(VC, C,
                                           grib->m_GribRecordPtrArray[Idx_SEACURRENT_VX],
                                           grib->m_GribRecordPtrArray[Idx_SEACURRENT_VY],
@@ -236,18 +280,220 @@ static bool GribCurrent(RouteMapConfiguration &configuration, double lat, double
     return true;
 }
 
+/* climatology is looked up across the plugin interface for every position and
+   every heading sailed, while it only varies over tens of miles and days, so it
+   is sampled at the nodes of a grid each hour and interpolated in between.  The
+   hour also keeps the arbitrary times of legs to the destination or along a
+   route from each filling the cache with their own nodes */
+#define CLIMATOLOGY_GRID_SPACING .5
+#define CLIMATOLOGY_SECONDS 3600
+#define MAX_CLIMATOLOGY_CACHE 200000
+#define CLIMATOLOGY_ATLAS -1 // setting of wind atlas nodes
+
+struct ClimatologyNode {
+    time_t time;
+    int setting, lat, lon;
+    bool operator<(const ClimatologyNode &o) const {
+        if(time != o.time) return time < o.time;
+        if(setting != o.setting) return setting < o.setting;
+        if(lat != o.lat) return lat < o.lat;
+        return lon < o.lon;
+    }
+};
+
+/* x and y of wind or current, or the atlas directions, speeds, storm and calm */
+struct ClimatologySample {
+    bool valid;
+    double values[18];
+};
+
+static wxMutex s_climatology_mutex;
+static std::map<ClimatologyNode, ClimatologySample> s_climatology_nodes;
+
+static bool ClimatologyNodeSample(int setting, const wxDateTime &time, int lat, int lon,
+                                  ClimatologySample &sample)
+{
+    time_t ticks = time.GetTicks();
+    ticks -= ticks % CLIMATOLOGY_SECONDS;
+    ClimatologyNode node = {ticks, setting, lat, lon};
+    {
+        wxMutexLocker lock(s_climatology_mutex);
+        std::map<ClimatologyNode, ClimatologySample>::iterator it = s_climatology_nodes.find(node);
+        if(it != s_climatology_nodes.end()) {
+            sample = it->second;
+            return sample.valid;
+        }
+    }
+
+    double nlat = lat*CLIMATOLOGY_GRID_SPACING, nlon = lon*CLIMATOLOGY_GRID_SPACING;
+    wxDateTime ntime((time_t)ticks);
+    if(setting == CLIMATOLOGY_ATLAS) {
+        int count = 8;
+        double *v = sample.values;
+        sample.valid = RouteMap::ClimatologyWindAtlasData(ntime, nlat, nlon, count,
+                                                          v, v+8, v[16], v[17]) && count == 8;
+    } else {
+        double dir, speed;
+        sample.valid = RouteMap::ClimatologyData(setting, ntime, nlat, nlon, dir, speed);
+        if(sample.valid) {
+            sample.values[0] = speed*cos(deg2rad(dir));
+            sample.values[1] = speed*sin(deg2rad(dir));
+        }
+    }
+
+    wxMutexLocker lock(s_climatology_mutex);
+    if(s_climatology_nodes.size() >= MAX_CLIMATOLOGY_CACHE)
+        s_climatology_nodes.clear();
+    s_climatology_nodes[node] = sample;
+    return sample.valid;
+}
+
+/* bilinear interpolation of the nodes around lat, lon, fails if any of them
+   has no data (eg: land) so the caller can look up the position itself */
+static bool ClimatologyGrid(int setting, const wxDateTime &time, double lat, double lon,
+                            int count, double *values)
+{
+    double glat = lat / CLIMATOLOGY_GRID_SPACING, glon = lon / CLIMATOLOGY_GRID_SPACING;
+    int ilat = floor(glat), ilon = floor(glon);
+    double dlat = glat - ilat, dlon = glon - ilon;
+
+    ClimatologySample s[4];
+    for(int i=0; i<4; i++)
+        if(!ClimatologyNodeSample(setting, time, ilat + i/2, ilon + i%2, s[i]))
+            return false;
+
+    for(int j=0; j<count; j++) {
+        double v1 = (1-dlon)*s[0].values[j] + dlon*s[1].values[j];
+        double v2 = (1-dlon)*s[2].values[j] + dlon*s[3].values[j];
+        values[j] = (1-dlat)*v1 + dlat*v2;
+    }
+    return true;
+}
+
+static bool GridClimatologyData(int setting, const wxDateTime &time, double lat, double lon,
+                                double &dir, double &speed)
+{
+    double v[2];
+    if(!ClimatologyGrid(setting, time, lat, lon, 2, v))
+        return RouteMap::ClimatologyData(setting, time, lat, lon, dir, speed);
+
+    dir = positive_degrees(rad2deg(atan2(v[1], v[0])));
+    speed = distance(v[0], v[1]);
+    return true;
+}
+
+static bool GridClimatologyWindAtlasData(const wxDateTime &time, double lat, double lon, int &count,
+                                         double *directions, double *speeds, double &storm, double &calm)
+{
+    double v[18];
+    if(count != 8 || !ClimatologyGrid(CLIMATOLOGY_ATLAS, time, lat, lon, 18, v))
+        return RouteMap::ClimatologyWindAtlasData(time, lat, lon, count,
+                                                  directions, speeds, storm, calm);
+
+    for(int i=0; i<8; i++) {
+        directions[i] = v[i];
+        speeds[i] = v[8+i];
+    }
+    storm = v[16], calm = v[17];
+    return true;
+}
+
+/* the climatology plugin scans its whole cyclone database for every segment
+   tested, while most of the ocean has no track in the date window, so with
+   CycloneCells the grid cells a segment touches are first tested for tracks
+   crossing their edges or diagonals, over a window a few days longer for storms
+   stalling in a cell.  This is an approximation: a track forming and dying
+   inside a cell without crossing a diagonal, or staying in it longer, is missed,
+   which is why it must be chosen in the configuration. */
+#define CYCLONE_CELL_DEGREES 1
+#define CYCLONE_CELL_DAYS 10
+#define MAX_CYCLONE_CELLS 4*4
+
+struct CycloneCell {
+    time_t day;
+    int dayrange, lat, lon;
+    bool operator<(const CycloneCell &o) const {
+        if(day != o.day) return day < o.day;
+        if(dayrange != o.dayrange) return dayrange < o.dayrange;
+        if(lat != o.lat) return lat < o.lat;
+        return lon < o.lon;
+    }
+};
+
+static std::map<CycloneCell, bool> s_cyclone_cells; // true if no track enters
+
+static bool CycloneCellClear(const wxDateTime &day, int dayrange, int lat, int lon)
+{
+    CycloneCell cell = {day.GetTicks(), dayrange, lat, lon};
+    {
+        wxMutexLocker lock(s_climatology_mutex);
+        std::map<CycloneCell, bool>::iterator it = s_cyclone_cells.find(cell);
+        if(it != s_cyclone_cells.end())
+            return it->second;
+    }
+
+    /* a day more so any time of the day is covered */
+    int range = dayrange + 1 + CYCLONE_CELL_DAYS;
+    double lat1 = lat*CYCLONE_CELL_DEGREES, lon1 = lon*CYCLONE_CELL_DEGREES;
+    double lat2 = lat1 + CYCLONE_CELL_DEGREES, lon2 = lon1 + CYCLONE_CELL_DEGREES;
+    bool clear =
+        RouteMap::ClimatologyCycloneTrackCrossings(lat1, lon1, lat1, lon2, day, range) == 0 &&
+        RouteMap::ClimatologyCycloneTrackCrossings(lat1, lon2, lat2, lon2, day, range) == 0 &&
+        RouteMap::ClimatologyCycloneTrackCrossings(lat2, lon2, lat2, lon1, day, range) == 0 &&
+        RouteMap::ClimatologyCycloneTrackCrossings(lat2, lon1, lat1, lon1, day, range) == 0 &&
+        RouteMap::ClimatologyCycloneTrackCrossings(lat1, lon1, lat2, lon2, day, range) == 0 &&
+        RouteMap::ClimatologyCycloneTrackCrossings(lat1, lon2, lat2, lon1, day, range) == 0;
+
+    wxMutexLocker lock(s_climatology_mutex);
+    if(s_cyclone_cells.size() >= MAX_CLIMATOLOGY_CACHE)
+        s_cyclone_cells.clear();
+    s_cyclone_cells[cell] = clear;
+    return clear;
+}
+
+static int CycloneTrackCrossings(double lat1, double lon1, double lat2, double lon2,
+                                 const wxDateTime &time, int dayrange, bool cells)
+{
+    if(cells && fabs(lon2 - lon1) < 180) {
+        int ilat1 = floor(wxMin(lat1, lat2) / CYCLONE_CELL_DEGREES);
+        int ilat2 = floor(wxMax(lat1, lat2) / CYCLONE_CELL_DEGREES);
+        int ilon1 = floor(wxMin(lon1, lon2) / CYCLONE_CELL_DEGREES);
+        int ilon2 = floor(wxMax(lon1, lon2) / CYCLONE_CELL_DEGREES);
+
+        if((ilat2 - ilat1 + 1)*(ilon2 - ilon1 + 1) <= MAX_CYCLONE_CELLS) {
+            wxDateTime day = time.GetDateOnly();
+            bool clear = true;
+            for(int ilat = ilat1; clear && ilat <= ilat2; ilat++)
+                for(int ilon = ilon1; clear && ilon <= ilon2; ilon++)
+                    clear = CycloneCellClear(day, dayrange, ilat, ilon);
+            if(clear)
+                return 0;
+        }
+    }
+
+    return RouteMap::ClimatologyCycloneTrackCrossings(lat1, lon1, lat2, lon2, time, dayrange);
+}
+
+void RouteMap::ClearClimatologyCache()
+{
+    wxMutexLocker lock(s_climatology_mutex);
+    s_climatology_nodes.clear();
+    s_cyclone_cells.clear();
+}
+
 static inline bool Current(RouteMapConfiguration &configuration,
                            double lat, double lon,
-                           double &C, double &VC, int &data_mask)
+                           double &C, double &VC, int &data_mask,
+                           const GribTileSample *sample = NULL)
 {
-    if(!configuration.grib_is_data_deficient && GribCurrent(configuration, lat, lon, C, VC)) {
+    if(!configuration.grib_is_data_deficient && GribCurrent(configuration, lat, lon, C, VC, sample)) {
         data_mask |= Position::GRIB_CURRENT;
         return true;
     }
 
     if(configuration.ClimatologyType != RouteMapConfiguration::DISABLED &&
        RouteMap::ClimatologyData &&
-       RouteMap::ClimatologyData(CURRENT, configuration.time, lat, lon, C, VC)) {
+       GridClimatologyData(CURRENT, configuration.time, lat, lon, C, VC)) {
         data_mask |= Position::CLIMATOLOGY_CURRENT;
         return true;
     }
@@ -387,7 +633,8 @@ static inline int TestIntersectionXY(double x1, double y1, double x2, double y2,
 Position::Position(double latitude, double longitude, Position *p,
                    double pheading, double pbearing, int sp, int t, int dm, bool df)
     : RoutePoint(latitude, longitude, sp, t, df), parent_heading(pheading),
-      parent_bearing(pbearing), parent(p), propagated(false), copied(false), data_mask(dm)
+      parent_bearing(pbearing), parent(p), propagated(false), copied(false), sampled(false),
+      deferred(false), data_mask(dm)
 {
     lat -= fmod(lat, EPSILON);
     lon -= fmod(lon, EPSILON);
@@ -397,7 +644,8 @@ Position::Position(Position *p)
     : RoutePoint(p->lat, p->lon, p->polar, p->tacks, p->grib_is_data_deficient),
       parent_heading(p->parent_heading),
       parent_bearing(p->parent_bearing), parent(p->parent),
-      propagated(p->propagated), copied(true), data_mask(p->data_mask)
+      propagated(p->propagated), copied(true), sampled(false), deferred(p->deferred),
+      data_mask(p->data_mask)
 {
 }
 
@@ -493,22 +741,23 @@ struct climatology_wind_atlas
 static inline bool ReadWindAndCurrents(RouteMapConfiguration &configuration, RoutePoint *p,
 /* normal data */
  double &WG, double &VWG, double &W, double &VW, double &C, double &VC,
- climatology_wind_atlas &atlas, int &data_mask)
+ climatology_wind_atlas &atlas, int &data_mask,
+ const GribTileSample *sample = NULL /* grib sampled at p if given */)
 {
     /* read current data */
     if(!configuration.Currents ||
-       !Current(configuration, p->lat, p->lon, C, VC, data_mask))
+       !Current(configuration, p->lat, p->lon, C, VC, data_mask, sample))
         C = VC = 0;
 
     for(;;) {
-        if(!configuration.grib_is_data_deficient && GribWind(configuration, p->lat, p->lon, WG, VWG)) {
+        if(!configuration.grib_is_data_deficient && GribWind(configuration, p->lat, p->lon, WG, VWG, sample)) {
             data_mask |= Position::GRIB_WIND;
             break;
         }
 
         if(configuration.ClimatologyType == RouteMapConfiguration::AVERAGE &&
            RouteMap::ClimatologyData &&
-           RouteMap::ClimatologyData(WIND, configuration.time, p->lat, p->lon, WG, VWG)) {
+           GridClimatologyData(WIND, configuration.time, p->lat, p->lon, WG, VWG)) {
             WG = heading_resolve(WG);
             data_mask |= Position::CLIMATOLOGY_WIND;
             break;
@@ -516,8 +765,8 @@ static inline bool ReadWindAndCurrents(RouteMapConfiguration &configuration, Rou
                   && RouteMap::ClimatologyWindAtlasData) {
             int windatlas_count = 8;
             double speeds[8];
-            if(RouteMap::ClimatologyWindAtlasData(configuration.time, p->lat, p->lon, windatlas_count,
-                                                  atlas.directions, speeds, atlas.storm, atlas.calm)) {
+            if(GridClimatologyWindAtlasData(configuration.time, p->lat, p->lon, windatlas_count,
+                                            atlas.directions, speeds, atlas.storm, atlas.calm)) {
                 /* compute wind speeds over water with the given current */
                 for(int i=0; i<windatlas_count; i++) {
                     double WG = i*360/windatlas_count;
@@ -563,7 +812,7 @@ static inline bool ReadWindAndCurrents(RouteMapConfiguration &configuration, Rou
             return false;
 
         /* try deficient grib if climatology failed */
-        if(configuration.grib_is_data_deficient && GribWind(configuration, p->lat, p->lon, WG, VWG)) {
+        if(configuration.grib_is_data_deficient && GribWind(configuration, p->lat, p->lon, WG, VWG, sample)) {
             data_mask |= Position::GRIB_WIND | Position::DATA_DEFICIENT_WIND;
             break;
         }
@@ -571,6 +820,7 @@ static inline bool ReadWindAndCurrents(RouteMapConfiguration &configuration, Rou
         if(!n || !n->parent)
             return false;
         p = n->parent;
+        sample = NULL; // no longer at the sampled location
     }
     VWG *= configuration.WindStrength;
 
@@ -585,17 +835,40 @@ bool RoutePoint::GetPlotData(RoutePoint *next, double dt, RouteMapConfiguration
     data.lon = lon;
     data.tacks = tacks;
     data.polar = polar;
-
-    data.WVHT = Swell(configuration, lat, lon);
-    data.VW_GUST = Gust(configuration, lat, lon);
     data.delta = dt;
 
+    Position *p = dynamic_cast<Position*>(this);
+    if(p && p->sampled.load(std::memory_order_acquire)) {
+        const PositionConditions &s = p->conditions;
+        data.WG = s.WG, data.VWG = s.VWG, data.W = s.W, data.VW = s.VW;
+        data.C = s.C, data.VC = s.VC, data.WVHT = s.WVHT, data.VW_GUST = s.VW_GUST;
+    } else if(!ReadPlotData(configuration, data))
+        return false;
+
+    ll_gc_ll_reverse(lat, lon, next->lat, next->lon, &data.BG, &data.VBG);
+    if(dt == 0)
+        data.VBG = 0;
+    else
+        data.VBG *= 3600 / dt;
+
+    OverWater(data.BG, data.VBG, data.C, data.VC, data.B, data.VB);
+    return true;
+}
+
+/* read conditions for a point which has no sample from propagating */
+bool RoutePoint::ReadPlotData(RouteMapConfiguration &configuration, PlotData &data)
+{
+    GribTileSample tile_sample;
+    const GribTileSample *sample = SampleGrib(configuration, lat, lon, tile_sample);
+    data.WVHT = Swell(configuration, lat, lon, sample);
+    data.VW_GUST = Gust(configuration, lat, lon, sample);
+
     climatology_wind_atlas atlas;
     int data_mask = 0; // not used for plotting yet
     bool old = configuration.grib_is_data_deficient;
     configuration.grib_is_data_deficient = grib_is_data_deficient;
     if(!ReadWindAndCurrents(configuration, this, data.WG, data.VWG,
-                            data.W, data.VW, data.C, data.VC, atlas, data_mask)) {
+                            data.W, data.VW, data.C, data.VC, atlas, data_mask, sample)) {
         // I don't think this can ever be hit, because the data should have been there
         // for the position be be created in the first place
         printf("Wind/Current data failed for position!!!\n");
@@ -603,13 +876,6 @@ bool RoutePoint::GetPlotData(RoutePoint *next, double dt, RouteMapConfiguration
         return false;
     }
 
-    ll_gc_ll_reverse(lat, lon, next->lat, next->lon, &data.BG, &data.VBG);
-    if(dt == 0)
-        data.VBG = 0;
-    else
-        data.VBG *= 3600 / dt;
-
-    OverWater(data.BG, data.VBG, data.C, data.VC, data.B, data.VB);
     configuration.grib_is_data_deficient = old;
     return true;
 }
@@ -634,14 +900,17 @@ static inline bool ComputeBoatSpeed
  climatology_wind_atlas &atlas, int data_mask,
  double &B, double &VB, double &BG, double &VBG, double &dist, int newpolar)
 {
-    Polar &polar = configuration.boat.Polars[newpolar];
+    const Polar &polar = configuration.GetBoat().Polars[newpolar];
     if((data_mask & Position::CLIMATOLOGY_WIND) &&
        (configuration.ClimatologyType == RouteMapConfiguration::CUMULATIVE_MAP ||
         configuration.ClimatologyType == RouteMapConfiguration::CUMULATIVE_MINUS_CALMS)) {
-        /* build map */
+        /* build map, octants the wind never blows from do not contribute */
         VB = 0;
         int windatlas_count = 8;
         for(int i = 0; i<windatlas_count; i++) {
+            if(atlas.directions[i] == 0)
+                continue;
+
             double dir = H-W+atlas.W[i];
             if(dir > 180)
                 dir = 360 - dir;
@@ -677,19 +946,21 @@ static inline bool ComputeBoatSpeed
     return true;
 }
 
-bool rk_step(Position *p, double timeseconds, double BG, double dist, double H,
+bool rk_step(Position *p, const Geodesy &origin, double timeseconds, double BG, double dist, double H,
              RouteMapConfiguration &configuration, WR_GribRecordSet *grib,
              const wxDateTime &time, int newpolar,
              double &rk_BG, double &rk_dist, int &data_mask)
 {
     double k1_lat, k1_lon;
-    ll_gc_ll(p->lat, p->lon, BG, dist, &k1_lat, &k1_lon);
+    origin.Destination(BG, dist, &k1_lat, &k1_lon);
 
     double WG, VWG, W, VW, C, VC;
     climatology_wind_atlas atlas;
     Position rk(k1_lat, k1_lon, p->parent); // parent so deficient data can find parent
+    GribTileSample tile_sample;
+    const GribTileSample *sample = SampleGrib(configuration, k1_lat, k1_lon, tile_sample);
     if(!ReadWindAndCurrents(configuration, &rk,
-                            WG, VWG, W, VW, C, VC, atlas, data_mask))
+                            WG, VWG, W, VW, C, VC, atlas, data_mask, sample))
         return false;
 
     double B = W + H; /* rotated relative to true wind */
@@ -703,9 +974,9 @@ bool rk_step(Position *p, double timeseconds, double BG, double dist, double H,
 }
 
 /* propagate to the end position in the configuration, and return the number of seconds it takes */
-double Position::PropagateToEnd(RouteMapConfiguration &cf, double &H, int &data_mask)
+double Position::PropagateToEnd(RouteMapConfiguration &cf, double &H, int &data_mask, int &newpolar)
 {
-    return PropagateToPoint(cf.EndLat, cf.EndLon, cf, H, data_mask, true);
+    return PropagateToPoint(cf.EndLat, cf.EndLon, cf, H, data_mask, newpolar, true);
 }
 
 static void DeletePoints(Position *point)
@@ -718,6 +989,243 @@ static void DeletePoints(Position *point)
     } while(p != point);
 }
 
+/* the position reached sailing at heading H relative to the wind for a step,
+   NULL if it cannot be sailed or leads somewhere not allowed */
+Position *Position::PropagateHeading(double H, RouteMapConfiguration &configuration, const Geodesy &origin,
+                                     double WG, double VWG, double W, double VW, double C, double VC,
+                                     double S, climatology_wind_atlas &atlas, int &data_mask)
+{
+    double timeseconds = configuration.UsedDeltaTime;
+    double dist;
+    double B, VB, BG, VBG;
+
+    B = W + H; /* rotated relative to true wind */
+
+    int newpolar = configuration.GetBoat().TrySwitchPolar(polar, VW, H, S, configuration.OptimizeTacking);
+    if(newpolar == -1) {
+        configuration.polar_failed = true;
+        return NULL;
+    }
+    if (polar == -1)
+        polar = newpolar;
+    
+    /* did we tack thru the wind? apply penalty */
+    bool tacked = false;
+    if(parent_heading*H < 0 && fabs(parent_heading - H) < 180) {
+        timeseconds -= configuration.TackingTime;
+        tacked = true;
+    }
+
+    if(!ComputeBoatSpeed(configuration, timeseconds, WG, VWG, W, VW, C, VC, H, atlas, data_mask,
+                         B, VB, BG, VBG, dist, newpolar))
+        return NULL;
+
+
+    double dlat, dlon;
+    if(configuration.Integrator == RouteMapConfiguration::RUNGE_KUTTA) {
+        double k2_dist, k2_BG, k3_dist, k3_BG, k4_dist, k4_BG;
+        // a lot more experimentation is needed here, maybe use grib for the right time??
+        wxDateTime rk_time_2 = configuration.time + wxTimeSpan::Seconds(timeseconds/2);
+        wxDateTime rk_time = configuration.time + wxTimeSpan::Seconds(timeseconds);
+        if(!rk_step(this, origin, timeseconds, BG,    dist/2, H,
+                    configuration, configuration.grib, rk_time_2, newpolar, k2_BG, k2_dist, data_mask) ||
+           !rk_step(this, origin, timeseconds, BG, k2_dist/2, H + k2_BG - BG,
+                    configuration, configuration.grib, rk_time_2, newpolar, k3_BG, k3_dist, data_mask) ||
+           !rk_step(this, origin, timeseconds, BG, k3_dist,   H + k3_BG - BG,
+                    configuration, configuration.grib, rk_time, newpolar, k4_BG, k4_dist, data_mask))
+            return NULL;
+
+        origin.Destination(BG, dist/6 + k2_dist/3 + k3_dist/3 + k4_dist/6, &dlat, &dlon);
+    } else /* newtons method */
+#if 1
+        origin.Destination(heading_resolve(BG), dist, &dlat, &dlon);
+#else
+    {
+        double d = dist / 60;
+        dlat = lat + d * cos(deg2rad(BG));
+        dlon = lon + d * sin(deg2rad(BG));
+        dlon = heading_resolve(dlon);
+    }
+#endif
+
+    if(configuration.positive_longitudes && dlon < 0)
+        dlon += 360;
+
+    if(configuration.MaxCourseAngle < 180) {
+        double bearing;
+        // this is faster than gc distance, and actually works better in higher latitudes
+        double d1 = dlat - configuration.StartLat, d2 = dlon - configuration.StartLon;
+        d2 *= cos(deg2rad(dlat))/2; // correct for latitude
+        bearing = rad2deg(atan2(d2, d1));
+
+        if(fabs(heading_resolve(configuration.StartEndBearing - bearing)) > configuration.MaxCourseAngle)
+            return NULL;
+    }
+
+    if(configuration.MaxDivertedCourse < 180) {
+        double bearing, dist;
+        double bearing1, dist1;
+
+        double d1 = dlat - configuration.EndLat, d2 = dlon - configuration.EndLon;
+        d2 *= cos(deg2rad(dlat))/2; // correct for latitude
+        bearing = rad2deg(atan2(d2, d1));
+        dist = sqrt(pow(d1, 2) + pow(d2, 2));
+
+        d1 = configuration.StartLat - dlat, d2 = configuration.StartLon - dlon;
+        bearing1 = rad2deg(atan2(d2, d1));
+        dist1 = sqrt(pow(d1, 2) + pow(d2, 2));
+
+        double term = (dist1 + dist) / dist;
+        term = pow(term/16, 4) + 1; // make 1 until the end, then make big
+
+        if(fabs(heading_resolve(bearing1 - bearing)) > configuration.MaxDivertedCourse * term)
+            return NULL;
+    }
+
+    /* quick test first to avoid slower calculation */
+    if(VB + VW > configuration.MaxApparentWindKnots &&
+       Polar::VelocityApparentWind(VB, H, VW) > configuration.MaxApparentWindKnots)
+        return NULL;
+
+    /* with deferred validation only tested once merged, if still on the isochron */
+    if(!configuration.DeferValidation && Obstructed(dlat, dlon, BG, dist, origin, configuration))
+        return NULL;
+
+    Position *rp = new Position(dlat, dlon, this, H, B, newpolar, tacks + tacked, data_mask,
+                                configuration.grib_is_data_deficient );
+    rp->deferred = configuration.DeferValidation;
+    return rp;
+}
+
+/* does sailing from here to dlat, dlon crossing land within the safety
+   margin, entering a boundary or crossing a cyclone track prevent it */
+bool Position::Obstructed(double dlat, double dlon, double BG, double dist, const Geodesy &origin,
+                          RouteMapConfiguration &configuration)
+{
+    if(configuration.DetectLand || configuration.DetectBoundary) {
+        double dlat1, dlon1; 
+        double bearing, dist2end;
+        double dist2test;
+
+        // it's not an error if there's boundaries after we reach destination
+        origin.Reverse(configuration.EndLat, configuration.EndLon, &bearing, &dist2end);
+        if(configuration.FollowerDestinations) {
+            const std::vector<std::pair<double, double> > &destinations = *configuration.FollowerDestinations;
+            for(std::vector<std::pair<double, double> >::const_iterator it = destinations.begin();
+                it != destinations.end(); it++) {
+                double d;
+                origin.Reverse(it->first, it->second, &bearing, &d);
+                if(d < dist2end)
+                    dist2end = d;
+            }
+        }
+        if (dist2end < dist) {
+            dist2test = dist2end;
+            origin.Destination(heading_resolve(BG), dist2test, &dlat1, &dlon1);
+        }
+        else {
+            dist2test = dist;
+            dlat1 = dlat;
+            dlon1 = dlon;
+        }
+ 
+        /* landfall test */
+        if(configuration.DetectLand) {
+            double ndlon1 = dlon1;
+            
+            // Check first if crossing land.
+            if (ndlon1 > 360) {
+                ndlon1 -= 360;
+            }
+            if (CrossesLand(dlat1, ndlon1))
+            {
+                configuration.land_crossing = true;
+                return true;
+            }
+        
+            // CUSTOMIZATION - Safety distance from land
+            // -----------------------------------------
+            // Modify the routing according to a safety
+            // margin defined by the user from the land.
+            // CONFIG: 2 NM as a security distance by default.
+            double distSecure = configuration.SafetyMarginLand;
+            double latBorderUp1, lonBorderUp1, latBorderUp2, lonBorderUp2;
+            double latBorderDown1, lonBorderDown1, latBorderDown2, lonBorderDown2;
+            
+            // Test if land is found within a rectangle with
+            // dimensiosn (dist, distSecure). Tests borders, plus diag,
+            // and middle of each side...
+            //            <- dist ->
+            // |-------------------------------|
+            // |                               |    ^
+            // |                               |    distSafety
+            // |-------------------------------|    ^
+            // |                               |
+            // |                               |
+            // |-------------------------------|
+            
+            // Fist, find the (lat,long) of each
+            // points of the rectangle
+            Geodesy end(dlat1, dlon1, configuration.GeodesyMode);
+            origin.Destination(heading_resolve(BG)-90, distSecure, &latBorderUp1, &lonBorderUp1);
+            end.Destination(heading_resolve(BG)-90, distSecure, &latBorderUp2, &lonBorderUp2);
+            origin.Destination(heading_resolve(BG)+90, distSecure, &latBorderDown1, &lonBorderDown1);
+            end.Destination(heading_resolve(BG)+90, distSecure, &latBorderDown2, &lonBorderDown2);
+            
+            // Then, test if there is land
+            if (PlugIn_GSHHS_CrossesLand(latBorderUp1, lonBorderUp1, latBorderUp2, lonBorderUp2) ||
+                PlugIn_GSHHS_CrossesLand(latBorderDown1, lonBorderDown1, latBorderDown2, lonBorderDown2) ||
+                PlugIn_GSHHS_CrossesLand(latBorderUp1, lonBorderUp1, latBorderDown2, lonBorderDown2) ||
+                PlugIn_GSHHS_CrossesLand(latBorderDown1, lonBorderDown1, latBorderUp2, lonBorderUp2))
+            {
+                configuration.land_crossing = true;
+                return true;
+            }
+        }
+
+        /* Boundary test */
+        if(configuration.DetectBoundary) {
+            if (EntersBoundary(dlat1, dlon1)) {
+                configuration.boundary_crossing = true;
+                return true;
+            }
+        }
+    }
+    /* crosses cyclone track(s)? */
+    if(configuration.AvoidCycloneTracks &&
+       RouteMap::ClimatologyCycloneTrackCrossings) {
+        int crossings = CycloneTrackCrossings
+            (lat, lon, dlat, dlon, configuration.time, configuration.CycloneMonths*30 +
+             configuration.CycloneDays, configuration.CycloneCells);
+        if(crossings > 0)
+            return true;
+    }
+
+    return false;
+}
+
+/* is bearing B backtracking, outside bearing1 to bearing2 */
+static inline bool Backtracks(double B, double bearing1, double bearing2)
+{
+    if(std::isnan(bearing1))
+        return false;
+
+    double bearing3 = heading_resolve(B);
+    return (bearing1 > bearing2 && bearing3 > bearing2 && bearing3 < bearing1) ||
+        (bearing1 < bearing2 && (bearing3 > bearing2 || bearing3 < bearing1));
+}
+
+/* do two neighbouring headings need one between them: one of them failed where
+   the other did not, or their positions are further apart than gap */
+static inline bool RefineHeadings(Position *p1, Position *p2, double gap)
+{
+    if(!p1 || !p2)
+        return p1 != p2;
+
+    double dlat = p2->lat - p1->lat, dlon = (p2->lon - p1->lon) * cos(deg2rad(p1->lat));
+    return dlat*dlat + dlon*dlon > gap*gap;
+}
+
 /* create a looped route by propagating from a position by computing
    the location the boat would be in if sailed at various angles */
 bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configuration)
@@ -728,11 +1236,23 @@ bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
 
     propagated = true;
 
+    /* even sailing straight at full speed, the destination is too far to beat the bound */
+    if(!std::isnan(configuration.GoalRange) &&
+       DistGreatCircle(lat, lon, configuration.EndLat, configuration.EndLon) > configuration.GoalRange)
+        return false;
+
+    /* too far off the route the coarse pass found */
+    if(configuration.corridor && !configuration.corridor->Contains(lat, lon))
+        return false;
+
     Position *points = NULL;
     /* through all angles relative to wind */
     int count = 0;
 
-    double S = Swell(configuration, lat, lon);
+    GribTileSample tile_sample;
+    const GribTileSample *sample = SampleGrib(configuration, lat, lon, tile_sample);
+
+    double S = Swell(configuration, lat, lon, sample);
     if(S > configuration.MaxSwellMeters)
         return false;
 
@@ -743,11 +1263,18 @@ bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
     climatology_wind_atlas atlas;
     int data_mask = 0;
     if(!ReadWindAndCurrents(configuration, this,
-                            WG, VWG, W, VW, C, VC, atlas, data_mask)) {
+                            WG, VWG, W, VW, C, VC, atlas, data_mask, sample)) {
         configuration.wind_data_failed = true;        
         return false;
     }
 
+    if(!sampled.load(std::memory_order_relaxed)) { // propagated again when anchoring
+        PositionConditions c = {(float)WG, (float)VWG, (float)W, (float)VW, (float)C, (float)VC,
+                                (float)S, (float)Gust(configuration, lat, lon, sample)};
+        conditions = c;
+        sampled.store(true, std::memory_order_release);
+    }
+
     if(VW > configuration.MaxTrueWindKnots)
         return false;
 
@@ -761,8 +1288,7 @@ bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
     }
 
 
-    bool first_avoid = true;
-    Position *rp;
+    Geodesy origin(lat, lon, configuration.GeodesyMode);
 
     double bearing1 = NAN, bearing2 = NAN;
     if(parent && configuration.MaxSearchAngle < 180) {
@@ -770,216 +1296,75 @@ bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
         bearing2 = heading_resolve( parent_bearing + configuration.MaxSearchAngle);
     }
 
-    for(auto it = configuration.DegreeSteps.begin();
-        it != configuration.DegreeSteps.end(); it++) {
-        double timeseconds = configuration.UsedDeltaTime;
-        double dist;
-
-
-        double H = heading_resolve(*it);
-        double B, VB, BG, VBG;
-
-        B = W + H; /* rotated relative to true wind */
-
-        /* test to avoid extra computations related to backtracking */
-        if(!std::isnan(bearing1)) {
-            double bearing3 = heading_resolve(B);
-            if((bearing1 > bearing2 && bearing3 > bearing2 && bearing3 < bearing1) ||
-               (bearing1 < bearing2 && (bearing3 > bearing2 || bearing3 < bearing1))) {
-                if(first_avoid) {
-                    /* add a position behind the lines to ensure our route intersects
-                       with the previous one to nicely merge the resulting graph */
-                    first_avoid = false;
-                    rp = new Position(this);
-                    double dp = .95;
-                    rp->lat = (1-dp)*lat + dp*parent->lat;
-                    rp->lon = (1-dp)*lon + dp*parent->lon;
-                    rp->propagated = true; // not a "real" position so we don't propagate it either.
-                    goto add_position;
-                } else
-                    continue;
-            }
-        }
-
-        {
-        int newpolar = configuration.boat.TrySwitchPolar(polar, VW, H, S, configuration.OptimizeTacking);
-        if(newpolar == -1) {
-            configuration.polar_failed = true;
-            continue;
-        }
-        if (polar == -1)
-            polar = newpolar;
-        
-        /* did we tack thru the wind? apply penalty */
-        bool tacked = false;
-        if(parent_heading*H < 0 && fabs(parent_heading - H) < 180) {
-            timeseconds -= configuration.TackingTime;
-            tacked = true;
-        }
-
-        if(!ComputeBoatSpeed(configuration, timeseconds, WG, VWG, W, VW, C, VC, H, atlas, data_mask,
-                             B, VB, BG, VBG, dist, newpolar))
+    const std::vector<double> &DegreeSteps = configuration.GetDegreeSteps();
+
+    /* headings not backtracking, the others are not sailed */
+    std::vector<int> headings;
+    for(unsigned int i = 0; i < DegreeSteps.size(); i++)
+        if(!Backtracks(W + heading_resolve(DegreeSteps[i]), bearing1, bearing2))
+            headings.push_back(i);
+
+    /* with adaptive headings sail a coarse fan first, then only fill in between
+       neighbours which failed differently or whose positions are far apart */
+    int stride = configuration.AdaptiveHeadings ? ADAPTIVE_HEADING_STRIDE : 1;
+    std::vector<Position*> reached(DegreeSteps.size(), (Position*)NULL);
+    std::vector<std::pair<int, int> > gaps;
+    double maxdist = 0;
+    for(unsigned int k = 0; k < headings.size(); k++) {
+        if(k % stride && k != headings.size() - 1)
             continue;
 
-
-        double dlat, dlon;
-        if(configuration.Integrator == RouteMapConfiguration::RUNGE_KUTTA) {
-            double k2_dist, k2_BG, k3_dist, k3_BG, k4_dist, k4_BG;
-            // a lot more experimentation is needed here, maybe use grib for the right time??
-            wxDateTime rk_time_2 = configuration.time + wxTimeSpan::Seconds(timeseconds/2);
-            wxDateTime rk_time = configuration.time + wxTimeSpan::Seconds(timeseconds);
-            if(!rk_step(this, timeseconds, BG,    dist/2, H,
-                        configuration, configuration.grib, rk_time_2, newpolar, k2_BG, k2_dist, data_mask) ||
-               !rk_step(this, timeseconds, BG, k2_dist/2, H + k2_BG - BG,
-                        configuration, configuration.grib, rk_time_2, newpolar, k3_BG, k3_dist, data_mask) ||
-               !rk_step(this, timeseconds, BG, k3_dist,   H + k3_BG - BG,
-                        configuration, configuration.grib, rk_time, newpolar, k4_BG, k4_dist, data_mask))
-                continue;
-
-            ll_gc_ll(lat, lon, BG, dist/6 + k2_dist/3 + k3_dist/3 + k4_dist/6, &dlat, &dlon);
-        } else /* newtons method */
-#if 1
-            ll_gc_ll(lat, lon, heading_resolve(BG), dist, &dlat, &dlon);
-#else
-        {
-            double d = dist / 60;
-            dlat = lat + d * cos(deg2rad(BG));
-            dlon = lon + d * sin(deg2rad(BG));
-            dlon = heading_resolve(dlon);
-        }
-#endif
-
-        if(configuration.positive_longitudes && dlon < 0)
-            dlon += 360;
-
-        if(configuration.MaxCourseAngle < 180) {
-            double bearing;
-            // this is faster than gc distance, and actually works better in higher latitudes
-            double d1 = dlat - configuration.StartLat, d2 = dlon - configuration.StartLon;
-            d2 *= cos(deg2rad(dlat))/2; // correct for latitude
-            bearing = rad2deg(atan2(d2, d1));
-
-            if(fabs(heading_resolve(configuration.StartEndBearing - bearing)) > configuration.MaxCourseAngle)
-                continue;
-        }
-
-        if(configuration.MaxDivertedCourse < 180) {
-            double bearing, dist;
-            double bearing1, dist1;
-
-            double d1 = dlat - configuration.EndLat, d2 = dlon - configuration.EndLon;
-            d2 *= cos(deg2rad(dlat))/2; // correct for latitude
-            bearing = rad2deg(atan2(d2, d1));
-            dist = sqrt(pow(d1, 2) + pow(d2, 2));
-
-            d1 = configuration.StartLat - dlat, d2 = configuration.StartLon - dlon;
-            bearing1 = rad2deg(atan2(d2, d1));
-            dist1 = sqrt(pow(d1, 2) + pow(d2, 2));
-
-            double term = (dist1 + dist) / dist;
-            term = pow(term/16, 4) + 1; // make 1 until the end, then make big
-
-            if(fabs(heading_resolve(bearing1 - bearing)) > configuration.MaxDivertedCourse * term)
-                continue;
+        int h = headings[k];
+        reached[h] = PropagateHeading(heading_resolve(DegreeSteps[h]), configuration, origin,
+                                      WG, VWG, W, VW, C, VC, S, atlas, data_mask);
+        if(reached[h])
+            maxdist = wxMax(maxdist, distance(reached[h]->lat - lat,
+                                              (reached[h]->lon - lon) * cos(deg2rad(lat))));
+
+        if(k > 0) {
+            int prev = (k - 1) / stride * stride;
+            if((int)k - prev > 1)
+                gaps.push_back(std::pair<int, int>(prev, k));
         }
+    }
 
-        /* quick test first to avoid slower calculation */
-        if(VB + VW > configuration.MaxApparentWindKnots &&
-           Polar::VelocityApparentWind(VB, H, VW) > configuration.MaxApparentWindKnots)
+    /* the gap the configured spacing would leave between the furthest positions */
+    double gap = DegreeSteps.size() > 1 ? maxdist * deg2rad(DegreeSteps[1] - DegreeSteps[0]) : 0;
+    while(gaps.size()) {
+        std::pair<int, int> g = gaps.back();
+        gaps.pop_back();
+        if(!RefineHeadings(reached[headings[g.first]], reached[headings[g.second]], gap))
             continue;
 
-        if(configuration.DetectLand || configuration.DetectBoundary) {
-            double dlat1, dlon1; 
-            double bearing, dist2end;
-            double dist2test;
-
-            // it's not an error if there's boundaries after we reach destination
-            ll_gc_ll_reverse(lat, lon, configuration.EndLat, configuration.EndLon, &bearing, &dist2end);
-            if (dist2end < dist) {
-                dist2test = dist2end;
-                ll_gc_ll(lat, lon, heading_resolve(BG), dist2test, &dlat1, &dlon1);
-            }
-            else {
-                dist2test = dist;
-                dlat1 = dlat;
-                dlon1 = dlon;
-            }
- 
-            /* landfall test */
-            if(configuration.DetectLand) {
-                double ndlon1 = dlon1;
-                
-                // Check first if crossing land.
-                if (ndlon1 > 360) {
-                    ndlon1 -= 360;
-                }
-                if (CrossesLand(dlat1, ndlon1))
-                {
-                    configuration.land_crossing = true;
-                    continue;
-                }
-            
-                // CUSTOMIZATION - Safety distance from land
-                // -----------------------------------------
-                // Modify the routing according to a safety
-                // margin defined by the user from the land.
-                // CONFIG: 2 NM as a security distance by default.
-                double distSecure = configuration.SafetyMarginLand;
-                double latBorderUp1, lonBorderUp1, latBorderUp2, lonBorderUp2;
-                double latBorderDown1, lonBorderDown1, latBorderDown2, lonBorderDown2;
-                
-                // Test if land is found within a rectangle with
-                // dimensiosn (dist, distSecure). Tests borders, plus diag,
-                // and middle of each side...
-                //            <- dist ->
-                // |-------------------------------|
-                // |                               |    ^
-                // |                               |    distSafety
-                // |-------------------------------|    ^
-                // |                               |
-                // |                               |
-                // |-------------------------------|
-                
-                // Fist, find the (lat,long) of each
-                // points of the rectangle
-                ll_gc_ll(lat, lon, heading_resolve(BG)-90, distSecure, &latBorderUp1, &lonBorderUp1);
-                ll_gc_ll(dlat1, dlon1, heading_resolve(BG)-90, distSecure, &latBorderUp2, &lonBorderUp2);
-                ll_gc_ll(lat, lon, heading_resolve(BG)+90, distSecure, &latBorderDown1, &lonBorderDown1);
-                ll_gc_ll(dlat1, dlon1, heading_resolve(BG)+90, distSecure, &latBorderDown2, &lonBorderDown2);
-                
-                // Then, test if there is land
-                if (PlugIn_GSHHS_CrossesLand(latBorderUp1, lonBorderUp1, latBorderUp2, lonBorderUp2) ||
-                    PlugIn_GSHHS_CrossesLand(latBorderDown1, lonBorderDown1, latBorderDown2, lonBorderDown2) ||
-                    PlugIn_GSHHS_CrossesLand(latBorderUp1, lonBorderUp1, latBorderDown2, lonBorderDown2) ||
-                    PlugIn_GSHHS_CrossesLand(latBorderDown1, lonBorderDown1, latBorderUp2, lonBorderUp2))
-                {
-                    configuration.land_crossing = true;
-                    continue;
-                }
-            }
+        int k = (g.first + g.second) / 2, h = headings[k];
+        reached[h] = PropagateHeading(heading_resolve(DegreeSteps[h]), configuration, origin,
+                                      WG, VWG, W, VW, C, VC, S, atlas, data_mask);
+        if(k - g.first > 1)
+            gaps.push_back(std::pair<int, int>(g.first, k));
+        if(g.second - k > 1)
+            gaps.push_back(std::pair<int, int>(k, g.second));
+    }
 
-            /* Boundary test */
-            if(configuration.DetectBoundary) {
-                if (EntersBoundary(dlat1, dlon1)) {
-                    configuration.boundary_crossing = true;
-                    continue;
-                }
-            }
-        }
-        /* crosses cyclone track(s)? */
-        if(configuration.AvoidCycloneTracks &&
-           RouteMap::ClimatologyCycloneTrackCrossings) {
-            int crossings = RouteMap::ClimatologyCycloneTrackCrossings
-                (lat, lon, dlat, dlon, configuration.time, configuration.CycloneMonths*30 +
-                 configuration.CycloneDays);
-            if(crossings > 0)
+    /* link the positions in order of heading */
+    bool first_avoid = true;
+    for(unsigned int i = 0, k = 0; i < DegreeSteps.size(); i++) {
+        Position *rp;
+        if(k < headings.size() && headings[k] == (int)i) {
+            k++;
+            rp = reached[i];
+            if(!rp)
                 continue;
-        }
-
-        rp = new Position(dlat, dlon, this, H, B, newpolar, tacks + tacked, data_mask,
-                    configuration.grib_is_data_deficient );
-    }
-    add_position:
+        } else if(first_avoid) {
+            /* add a position behind the lines to ensure our route intersects
+               with the previous one to nicely merge the resulting graph */
+            first_avoid = false;
+            rp = new Position(this);
+            double dp = .95;
+            rp->lat = (1-dp)*lat + dp*parent->lat;
+            rp->lon = (1-dp)*lon + dp*parent->lon;
+            rp->propagated = true; // not a "real" position so we don't propagate it either.
+        } else
+            continue;
 
         if(points) {
             rp->prev=points->prev;
@@ -1004,10 +1389,25 @@ bool Position::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
     return true;
 }
 
+/* fastest speed through the water of any polar of the boat */
+static double MaxBoatSpeed(RouteMapConfiguration &configuration)
+{
+    double speed = 0;
+    const std::vector<Polar> &polars = configuration.GetBoat().Polars;
+    for(std::vector<Polar>::const_iterator it = polars.begin(); it != polars.end(); it++)
+        speed = wxMax(speed, it->MaxSpeed());
+    return speed;
+}
+
+/* the polar sailed is returned in newpolar, this point is not modified
+   as positions of isochrons are shared by the maps following them */
 double RoutePoint::PropagateToPoint(double dlat, double dlon, RouteMapConfiguration &configuration,
-                             double &H, int &data_mask, bool end)
+                                    double &H, int &data_mask, int &newpolar, bool end)
 {
-    double S = Swell(configuration, lat, lon);
+    GribTileSample tile_sample;
+    const GribTileSample *sample = SampleGrib(configuration, lat, lon, tile_sample);
+
+    double S = Swell(configuration, lat, lon, sample);
     if(S > configuration.MaxSwellMeters)
         return NAN;
 
@@ -1017,7 +1417,7 @@ double RoutePoint::PropagateToPoint(double dlat, double dlon, RouteMapConfigurat
     double WG, VWG, W, VW, C, VC;
     climatology_wind_atlas atlas;
     if(!ReadWindAndCurrents(configuration, this,
-                            WG, VWG, W, VW, C, VC, atlas, data_mask)) {
+                            WG, VWG, W, VW, C, VC, atlas, data_mask, sample)) {
         if (!end) configuration.wind_data_failed = true;
         return NAN;
     }
@@ -1030,28 +1430,35 @@ double RoutePoint::PropagateToPoint(double dlat, double dlon, RouteMapConfigurat
     double bearing, dist;
     ll_gc_ll_reverse(lat, lon, dlat, dlon, &bearing, &dist);
 
-    /* figure out bearing and distance to go, because it is a non-linear problem if compounded
-       with currents solve iteratively (without currents only one iteration will ever occur */
-    double B, VB, BG = W, VBG;
+    /* figure out the heading which makes good the bearing over ground.  Without
+       currents the first heading is exact.  Otherwise the course error is a smooth
+       function of heading, solved with secant steps which fall back to bisecting
+       once the error changed sign and a step leaves that bracket. */
+    if(VC > 0) {
+        /* no heading makes good the bearing if even the fastest boat speed can not
+           cancel the current across the track and then make way against it */
+        double maxspeed = MaxBoatSpeed(configuration);
+        double cross = VC * sin(deg2rad(C - bearing)), along = VC * cos(deg2rad(C - bearing));
+        if(fabs(cross) >= maxspeed || sqrt(maxspeed*maxspeed - cross*cross) + along <= 0)
+            return NAN;
+    }
+
+    double B, VB, BG, VBG;
     int iters = 0;
-    H = 0;
-    int newpolar = polar;
+    newpolar = polar;
     bool old = configuration.OptimizeTacking;
     if (end)
         configuration.OptimizeTacking = true;
-    do {
-        /* make our correction in range */
-        while(bearing - BG > 180)
-            bearing -= 360;
-        while(BG - bearing > 180)
-            bearing += 360;
 
-        H += bearing - BG;
+    double Hlow = NAN, Hhigh = NAN; // headings with error below and above zero
+    double Hprev = NAN, fprev = NAN;
+    H = heading_resolve(bearing - W);
+    for(;;) {
         B = W + H; /* rotated relative to true wind */
 
         double dummy_dist; // not used
 
-        newpolar = configuration.boat.TrySwitchPolar(polar, VW, H, S, configuration.OptimizeTacking);
+        newpolar = configuration.GetBoat().TrySwitchPolar(polar, VW, H, S, configuration.OptimizeTacking);
         if(newpolar == -1) {
             configuration.polar_failed = true;
             configuration.OptimizeTacking = old;
@@ -1059,19 +1466,47 @@ double RoutePoint::PropagateToPoint(double dlat, double dlon, RouteMapConfigurat
         }
 
         if(!ComputeBoatSpeed(configuration, 0, WG, VWG, W, VW, C, VC, H, atlas, data_mask,
-                             B, VB, BG, VBG, dummy_dist, newpolar)
-                || ++iters == 10 // give up
-          ) {
+                             B, VB, BG, VBG, dummy_dist, newpolar)) {
             configuration.OptimizeTacking = old;
             return NAN;
         }
-    } while((bearing - BG) > 1e-3);
+
+        double f = heading_resolve(BG - bearing);
+        if(fabs(f) <= 1e-3)
+            break;
+
+        if(f < 0)
+            Hlow = H;
+        else
+            Hhigh = H;
+
+        /* give up, also when the error keeps its sign, there is likely no solution */
+        bool bracket = !std::isnan(Hlow) && !std::isnan(Hhigh);
+        if(++iters == 10 || (iters == 4 && !bracket)) {
+            configuration.OptimizeTacking = old;
+            return NAN;
+        }
+
+        double Hnext;
+        if(std::isnan(Hprev) || f == fprev)
+            Hnext = H - f;
+        else
+            Hnext = H - f * heading_resolve(H - Hprev) / (f - fprev);
+
+        /* headings wrap, so the bracket is measured from its low end */
+        if(bracket) {
+            double width = heading_resolve(Hhigh - Hlow), step = heading_resolve(Hnext - Hlow);
+            if(width * step <= 0 || fabs(step) >= fabs(width))
+                Hnext = Hlow + width / 2;
+        }
+
+        Hprev = H, fprev = f;
+        H = heading_resolve(Hnext);
+    }
     configuration.OptimizeTacking = old;
 
-    /* only allow if we fit in the isochron time.  We could optimize this by finding
-       the maximum boat speed once, and using that before computing boat speed for
-       this angle, but for now, we don't worry because propagating to the end is a
-       small amount of total computation */
+    /* only allow if we fit in the isochron time, IsoChron::PropagateToEnd
+       already skips positions which cannot at the maximum boat speed */
     if(end && dist / VBG > configuration.UsedDeltaTime / 3600.0)
         return NAN;
 
@@ -1095,15 +1530,14 @@ double RoutePoint::PropagateToPoint(double dlat, double dlon, RouteMapConfigurat
     /* crosses cyclone track(s)? */
     if(configuration.AvoidCycloneTracks &&
        RouteMap::ClimatologyCycloneTrackCrossings) {
-        int crossings = RouteMap::ClimatologyCycloneTrackCrossings
+        int crossings = CycloneTrackCrossings
             (lat, lon, configuration.EndLat, configuration.EndLon,
              configuration.time, configuration.CycloneMonths*30 +
-             configuration.CycloneDays);
+             configuration.CycloneDays, configuration.CycloneCells);
 
         if(crossings > 0)
             return NAN;
     }
-    polar = newpolar;
 
     return 3600.0 * dist / VBG;
 }
@@ -1126,8 +1560,15 @@ int Position::SailChanges()
     return (polar != parent->polar) + parent->SailChanges();
 }
 
+/* ocpn_draw must not be called from several route map threads at once */
+static wxMutex s_boundary_mutex;
+
 bool RoutePoint::EntersBoundary(double dlat, double dlon)
 {
+    wxMutexLocker lock(s_boundary_mutex);
+    if(!RouteMap::ODFindClosestBoundaryLineCrossing) // ocpn_draw went away
+        return false;
+
     struct FindClosestBoundaryLineCrossing_t t;
     t.dStartLat = lat, t.dStartLon = heading_resolve(lon);
     t.dEndLat = dlat, t.dEndLon = heading_resolve(dlon);
@@ -1137,6 +1578,13 @@ bool RoutePoint::EntersBoundary(double dlat, double dlon)
     return RouteMap::ODFindClosestBoundaryLineCrossing(&t);
 }
 
+/* the pointer is read by route map threads, only change it under their mutex */
+void RouteMap::SetODFindClosestBoundaryLineCrossing(OD_FindClosestBoundaryLineCrossing f)
+{
+    wxMutexLocker lock(s_boundary_mutex);
+    ODFindClosestBoundaryLineCrossing = f;
+}
+
 SkipPosition::SkipPosition(Position *p, int q)
  : point(p), quadrant(q)
 {
@@ -1207,7 +1655,7 @@ void DeleteSkipPoints(SkipPosition *skippoints)
 }
 
 IsoRoute::IsoRoute(SkipPosition *s, int dir)
-    : skippoints(s), direction(dir), parent(NULL)
+    : skippoints(s), direction(dir), parent(NULL), index(NULL)
 {
     /* make sure the skip points start at the minimum
        latitude so we know we are on the outside */
@@ -1216,12 +1664,14 @@ IsoRoute::IsoRoute(SkipPosition *s, int dir)
 
 /* copy constructor */
 IsoRoute::IsoRoute(IsoRoute *r, IsoRoute *p)
-    : skippoints(r->skippoints->Copy()), direction(r->direction), parent(p)
+    : skippoints(r->skippoints->Copy()), direction(r->direction), parent(p), index(NULL)
 {
 }
 
 IsoRoute::~IsoRoute()
 {
+    delete index;
+
     for(IsoRouteList::iterator it = children.begin(); it != children.end(); ++it)
         delete *it;
 
@@ -1275,6 +1725,9 @@ void IsoRoute::MinimizeLat()
    return -1 if inconclusive */
 int IsoRoute::IntersectionCount(Position &pos)
 {
+    if(index)
+        return index->IntersectionCount(pos.lat, pos.lon);
+
     int numintsct = 0;
     double lat = pos.lat, lon = pos.lon;
 
@@ -1372,6 +1825,129 @@ int IsoRoute::Contains(Position &pos, bool test_children)
     return numintsct&1; /* odd */
 }
 
+/* latitudes where this route and its children cross the meridian at lon,
+   a point on the meridian is inside if an odd number of them lie above it */
+void IsoRoute::Crossings(double lon, std::vector<double> &lats)
+{
+    if(index)
+        index->Crossings(lon, lats);
+    else {
+        Position *p1 = skippoints->point;
+        do {
+            Position *p2 = p1->next;
+            if((lon < p1->lon) != (lon < p2->lon))
+                lats.push_back(p1->lat + (lon - p1->lon) * (p2->lat - p1->lat) / (p2->lon - p1->lon));
+            p1 = p2;
+        } while(p1 != skippoints->point);
+    }
+
+    for(IsoRouteList::iterator it = children.begin(); it != children.end(); it++)
+        (*it)->Crossings(lon, lats);
+}
+
+/* only call once the route is final, eg: when it is stored in an isochron */
+void IsoRoute::BuildIndex()
+{
+    delete index;
+    index = new IsoRouteIndex(this);
+
+    for(IsoRouteList::iterator it = children.begin(); it != children.end(); it++)
+        (*it)->BuildIndex();
+}
+
+IsoRouteIndex::IsoRouteIndex(IsoRoute *r)
+{
+    Position *first = r->skippoints->point, *p;
+
+    int count = 0;
+    m_MinLon = m_MaxLon = first->lon;
+    p = first;
+    do {
+        m_MinLon = wxMin(m_MinLon, p->lon);
+        m_MaxLon = wxMax(m_MaxLon, p->lon);
+        count++;
+        p = p->next;
+    } while(p != first);
+
+    /* a few edges per band on average */
+    int bands = wxMax(count / 2, 1);
+    double width = m_MaxLon - m_MinLon;
+    m_BandsPerDegree = width > 0 ? bands / width : 0;
+
+    /* count the edges in each band, then place them */
+    m_BandStart.assign(bands + 1, 0);
+    p = first;
+    do {
+        Position *q = p->next;
+        int b0 = Band(wxMin(p->lon, q->lon)), b1 = Band(wxMax(p->lon, q->lon));
+        for(int b = b0; b <= b1; b++)
+            m_BandStart[b+1]++;
+        p = q;
+    } while(p != first);
+
+    for(int b = 0; b < bands; b++)
+        m_BandStart[b+1] += m_BandStart[b];
+
+    std::vector<int> fill(m_BandStart.begin(), m_BandStart.end() - 1);
+    m_Edges.resize(m_BandStart[bands]);
+    p = first;
+    do {
+        Position *q = p->next;
+        Edge e = {p->lat, p->lon, q->lat, q->lon};
+        int b0 = Band(wxMin(p->lon, q->lon)), b1 = Band(wxMax(p->lon, q->lon));
+        for(int b = b0; b <= b1; b++)
+            m_Edges[fill[b]++] = e;
+        p = q;
+    } while(p != first);
+}
+
+int IsoRouteIndex::Band(double lon) const
+{
+    int b = floor((lon - m_MinLon) * m_BandsPerDegree);
+    return wxMax(wxMin(b, (int)m_BandStart.size() - 2), 0);
+}
+
+/* same test as IsoRoute::IntersectionCount but only for the
+   edges in the band of this longitude */
+int IsoRouteIndex::IntersectionCount(double lat, double lon) const
+{
+    if(lon < m_MinLon || lon >= m_MaxLon)
+        return 0;
+
+    int numintsct = 0, b = Band(lon);
+    for(int i = m_BandStart[b]; i < m_BandStart[b+1]; i++) {
+        const Edge &e = m_Edges[i];
+        if((lon < e.lon1) == (lon < e.lon2))
+            continue;
+
+        switch((lat < e.lat1) + (lat < e.lat2)) {
+        case 1: /* must perform exact intersection test */
+        {
+            double m1 = (lat - e.lat1) * (e.lon2 - e.lon1);
+            double m2 = (lon - e.lon1) * (e.lat2 - e.lat1);
+            if(e.lon1 < e.lon2 ? m1 < m2 : m1 > m2)
+                numintsct++;
+        } break;
+        case 2: /* must intersect, we are below */
+            numintsct++;
+        }
+    }
+    return numintsct;
+}
+
+void IsoRouteIndex::Crossings(double lon, std::vector<double> &lats) const
+{
+    if(lon < m_MinLon || lon >= m_MaxLon)
+        return;
+
+    int b = Band(lon);
+    for(int i = m_BandStart[b]; i < m_BandStart[b+1]; i++) {
+        const Edge &e = m_Edges[i];
+        if((lon < e.lon1) != (lon < e.lon2))
+            lats.push_back(e.lat1 + (lon - e.lon1) * (e.lat2 - e.lat1) / (e.lon2 - e.lon1));
+    }
+}
+
 /* This function is very slow, and should probably be removed
    or replaced with something else.. see how often it is called */
 bool IsoRoute::CompletelyContained(IsoRoute *r)
@@ -2293,39 +2869,16 @@ bool IsoRoute::Propagate(IsoRouteList &routelist, RouteMapConfiguration &configu
     return ret;
 }
 
-void IsoRoute::PropagateToEnd(RouteMapConfiguration &configuration, double &mindt,
-                              Position *&endp, double &minH, bool &mintacked, int &mindata_mask)
+void IsoRoute::AppendPositions(std::vector<Position*> &positions)
 {
     Position *p = skippoints->point;
-
     do {
-        double H;
-        int data_mask = 0;
-        double dt = p->PropagateToEnd(configuration, H, data_mask);
-
-        /* did we tack thru the wind? apply penalty */
-        bool tacked = false;
-        if(!std::isnan(dt) && p->parent_heading*H < 0 && fabs(p->parent_heading - H) < 180) {
-            tacked = true;
-            dt += configuration.TackingTime;
-#if 0        
-            if(configuration.MaxTacks >= 0 && p->tacks >= configuration.MaxTacks)
-                dt = NAN;
-#endif
-        }
-
-        if(!std::isnan(dt) && dt < mindt) {
-            mindt = dt;
-            minH = H;
-            endp = p;
-            mintacked = tacked;
-            mindata_mask = data_mask;
-        }
+        positions.push_back(p);
         p = p->next;
     } while(p != skippoints->point);
 
     for(IsoRouteList::iterator cit = children.begin(); cit != children.end(); cit++)
-        (*cit)->PropagateToEnd(configuration, mindt, endp, minH, mintacked, mindata_mask);
+        (*cit)->AppendPositions(positions);
 }
 
 int IsoRoute::SkipCount()
@@ -2371,9 +2924,15 @@ typedef  wxWeakRef<Shared_GribRecordSet> Shared_GribRecordSetRef;
 static std::map<time_t, Shared_GribRecordSetRef> grib_key;
 static wxMutex s_key_mutex;
 
+/* memory held by prefetched gribs of all route maps, under s_key_mutex */
+static size_t s_prefetched_size;
+
 IsoChron::IsoChron(IsoRouteList r, wxDateTime t, double d, Shared_GribRecordSet &g, bool grib_is_data_deficient)
     : routes(r), time(t), delta(d), m_SharedGrib(g), m_Grib(0), m_Grib_is_data_deficient(grib_is_data_deficient)
 {
+    for(IsoRouteList::iterator it = routes.begin(); it != routes.end(); ++it)
+        (*it)->BuildIndex();
+
     m_Grib = m_SharedGrib.GetGribRecordSet();
     if (m_Grib ) {
         wxMutexLocker lock(s_key_mutex);
@@ -2439,6 +2998,174 @@ void IsoChron::PropagateIntoList(IsoRouteList &routelist, RouteMapConfiguration
     }
 }
 
+/* fastest current the propagation can read with this configuration's grib,
+   INFINITY when it can not be known (climatology, or gribs requested through
+   plugin messages) */
+static double MaxCurrentKnots(RouteMapConfiguration &configuration)
+{
+    if(!configuration.Currents)
+        return 0;
+
+    if(configuration.ClimatologyType != RouteMapConfiguration::DISABLED &&
+       RouteMap::ClimatologyData)
+        return INFINITY;
+
+    if(configuration.grib_is_data_deficient)
+        return 0; // deficient grib currents are not used
+
+    WR_GribRecordSet *grib = configuration.grib;
+    if(!grib)
+        return !configuration.RouteGUID.IsEmpty() && configuration.UseGrib ? INFINITY : 0;
+
+    const GribRecord *GRX = grib->m_GribRecordPtrArray[Idx_SEACURRENT_VX];
+    const GribRecord *GRY = grib->m_GribRecordPtrArray[Idx_SEACURRENT_VY];
+    if(!GRX || !GRY)
+        return 0;
+    if(GRX->getNi() != GRY->getNi() || GRX->getNj() != GRY->getNj())
+        return INFINITY;
+
+    /* interpolating the components never gives a faster current than the records */
+    double max = 0;
+    for(int j = 0; j < GRX->getNj(); j++)
+        for(int i = 0; i < GRX->getNi(); i++)
+            if(GRX->isDefined(i, j) && GRY->isDefined(i, j)) {
+                double vx = GRX->getValue(i, j), vy = GRY->getValue(i, j);
+                max = wxMax(max, vx*vx + vy*vy);
+            }
+    return sqrt(max) * 3.6 / 1.852; // knots
+}
+
+/* no boat speed over ground exceeds this, positions needing to be
+   faster to arrive in time can be pruned without losing the best route */
+static double MaxSpeedOverGround(RouteMapConfiguration &configuration)
+{
+    return MaxBoatSpeed(configuration) + MaxCurrentKnots(configuration);
+}
+
+/* propagates every stride-th of the positions sorted by distance to the end,
+   so each thread finds a good time early and stops at the first position which
+   could not arrive sooner even at the boat's fastest speed */
+class PropagateToEndThread : public wxThread
+{
+public:
+    PropagateToEndThread(const RouteMapConfiguration &configuration,
+                         const std::vector<std::pair<double, Position*> > &positions,
+                         int first, int stride, double maxspeed)
+        : wxThread(wxTHREAD_JOINABLE), m_configuration(configuration), m_positions(positions),
+          m_first(first), m_stride(stride), m_maxspeed(maxspeed),
+          mindt(INFINITY), endp(NULL), minH(NAN), mintacked(false), mindata_mask(0), minpolar(-1) {}
+
+    void *Entry() {
+        Work();
+        return 0;
+    }
+
+    void Work() {
+        for(unsigned int i = m_first; i < m_positions.size(); i += m_stride) {
+            /* the distance is not from the same ellipsoid, allow 1% */
+            double bound = 3600 * m_positions[i].first / (m_maxspeed * 1.01);
+            if(bound >= mindt || bound > m_configuration.UsedDeltaTime)
+                break;
+
+            Position *p = m_positions[i].second;
+            double H;
+            int data_mask = 0, newpolar;
+            double dt = p->PropagateToEnd(m_configuration, H, data_mask, newpolar);
+
+            /* did we tack thru the wind? apply penalty */
+            bool tacked = false;
+            if(!std::isnan(dt) && p->parent_heading*H < 0 && fabs(p->parent_heading - H) < 180) {
+                tacked = true;
+                dt += m_configuration.TackingTime;
+#if 0
+                if(m_configuration.MaxTacks >= 0 && p->tacks >= m_configuration.MaxTacks)
+                    dt = NAN;
+#endif
+            }
+
+            if(!std::isnan(dt) && dt < mindt) {
+                mindt = dt;
+                minH = H;
+                endp = p;
+                mintacked = tacked;
+                mindata_mask = data_mask;
+                minpolar = newpolar;
+            }
+        }
+    }
+
+private:
+    RouteMapConfiguration m_configuration;
+    const std::vector<std::pair<double, Position*> > &m_positions;
+    int m_first, m_stride;
+    double m_maxspeed;
+
+public:
+    double mindt;
+    Position *endp;
+    double minH;
+    bool mintacked;
+    int mindata_mask;
+    int minpolar;
+};
+
+static bool SortByDistance(const std::pair<double, Position*> &a,
+                           const std::pair<double, Position*> &b)
+{
+    return a.first < b.first;
+}
+
+/* find the fastest position of this isochron to propagate to the end from */
+void IsoChron::PropagateToEnd(RouteMapConfiguration &configuration, double &mindt, Position *&endp,
+                              double &minH, bool &mintacked, int &mindata_mask, int &minpolar)
+{
+    std::vector<Position*> positions;
+    for(IsoRouteList::iterator it = routes.begin(); it != routes.end(); ++it)
+        (*it)->AppendPositions(positions);
+
+    std::vector<std::pair<double, Position*> > sorted;
+    sorted.reserve(positions.size());
+    for(unsigned int i = 0; i < positions.size(); i++)
+        sorted.push_back(std::make_pair(DistGreatCircle(positions[i]->lat, positions[i]->lon,
+                                                        configuration.EndLat, configuration.EndLon),
+                                        positions[i]));
+    std::stable_sort(sorted.begin(), sorted.end(), SortByDistance);
+
+    /* a few dozen positions per thread are not worth starting it,
+       and grib requests through plugin messages are not reentrant */
+    int count = wxMax(wxMin(wxThread::GetCPUCount(), (int)sorted.size() / 64), 1);
+    if(!configuration.grib && !configuration.RouteGUID.IsEmpty() && configuration.UseGrib)
+        count = 1;
+
+    double maxspeed = MaxSpeedOverGround(configuration);
+    std::vector<PropagateToEndThread*> threads;
+    std::vector<bool> running;
+    for(int i = 0; i < count; i++) {
+        PropagateToEndThread *thread = new PropagateToEndThread(configuration, sorted, i, count, maxspeed);
+        bool run = i < count-1 && thread->Create() == wxTHREAD_NO_ERROR &&
+            thread->Run() == wxTHREAD_NO_ERROR;
+        if(!run)
+            thread->Work();
+        threads.push_back(thread);
+        running.push_back(run);
+    }
+
+    for(int i = 0; i < count; i++) {
+        PropagateToEndThread *thread = threads[i];
+        if(running[i])
+            thread->Wait();
+        if(thread->mindt < mindt) {
+            mindt = thread->mindt;
+            endp = thread->endp;
+            minH = thread->minH;
+            mintacked = thread->mintacked;
+            mindata_mask = thread->mindata_mask;
+            minpolar = thread->minpolar;
+        }
+        delete thread;
+    }
+}
+
 bool IsoChron::Contains(Position &p)
 {
     for(IsoRouteList::iterator it = routes.begin(); it != routes.end(); ++it)
@@ -2456,6 +3183,26 @@ bool IsoChron::Contains(double lat, double lon)
     return Contains(p);
 }
 
+/* test many points on one meridian, the crossings of each route are
+   found once, then each point only needs a binary search */
+void IsoChron::Contains(double lon, const std::vector<double> &lats, std::vector<bool> &inside)
+{
+    inside.assign(lats.size(), false);
+
+    std::vector<double> crossings;
+    for(IsoRouteList::iterator it = routes.begin(); it != routes.end(); ++it) {
+        crossings.clear();
+        (*it)->Crossings(lon, crossings);
+        std::sort(crossings.begin(), crossings.end());
+
+        for(unsigned int i = 0; i < lats.size(); i++) {
+            int above = crossings.end() - std::upper_bound(crossings.begin(), crossings.end(), lats[i]);
+            if(above & 1)
+                inside[i] = true;
+        }
+    }
+}
+
 Position* IsoChron::ClosestPosition(double lat, double lon, wxDateTime *t, double *d)
 {
     Position *minpos = NULL;
@@ -2538,7 +3285,7 @@ bool RouteMapConfiguration::Update()
 
     ll_gc_ll_reverse(StartLat, StartLon, EndLat, EndLon, &StartEndBearing, 0);
 
-    DegreeSteps.clear();
+    std::vector<double> DegreeSteps;
     if (RouteGUID.IsEmpty()) {
         // ensure validity
         FromDegree = wxMax(wxMin(FromDegree, 180), 0);
@@ -2555,11 +3302,72 @@ bool RouteMapConfiguration::Update()
     else {
         DegreeSteps.push_back(0.);
     }
-    DegreeSteps.sort();
+    std::sort(DegreeSteps.begin(), DegreeSteps.end());
+
+    /* copies already made keep the old steps */
+    if(DegreeSteps != *m_DegreeSteps)
+        m_DegreeSteps = std::shared_ptr<const std::vector<double> >(new std::vector<double>(DegreeSteps));
 
     return true;
 }
 
+/* keep every factor'th heading */
+void RouteMapConfiguration::CoarsenDegreeSteps(int factor)
+{
+    std::vector<double> DegreeSteps;
+    for(unsigned int i = 0; i < m_DegreeSteps->size(); i += factor)
+        DegreeSteps.push_back((*m_DegreeSteps)[i]);
+    m_DegreeSteps = std::shared_ptr<const std::vector<double> >(new std::vector<double>(DegreeSteps));
+}
+
+/* distance in miles to the nearest segment, each taken as flat */
+double RouteCorridor::Distance(double lat, double lon) const
+{
+    double mindist = INFINITY;
+    double coslat = cos(deg2rad(lat));
+    for(unsigned int i = 1; i < lats.size(); i++) {
+        double x1 = (lons[i-1] - lon)*coslat, y1 = lats[i-1] - lat;
+        double x2 = (lons[i] - lon)*coslat, y2 = lats[i] - lat;
+        double dx = x2 - x1, dy = y2 - y1, l = dx*dx + dy*dy;
+        double t = l > 0 ? wxMax(wxMin(-(x1*dx + y1*dy) / l, 1), 0) : 0;
+        double x = x1 + t*dx, y = y1 + t*dy;
+        mindist = wxMin(mindist, x*x + y*y);
+    }
+    return 60*sqrt(mindist);
+}
+
+/* boats loaded by any configuration, an entry is reused while some configuration
+   still holds the boat and the file has the modification time it was read with */
+static wxMutex s_boats_mutex;
+static std::map<wxString, std::weak_ptr<const Boat> > s_boats;
+
+wxString RouteMapConfiguration::LoadBoat()
+{
+    if(m_Boat->IsLoaded(boatFileName))
+        return _T("");
+
+    wxMutexLocker lock(s_boats_mutex);
+    std::shared_ptr<const Boat> shared = s_boats[boatFileName].lock();
+    if(shared && shared->IsLoaded(boatFileName)) {
+        m_Boat = shared;
+        return _T("");
+    }
+
+    /* forget boats no configuration uses anymore */
+    for(std::map<wxString, std::weak_ptr<const Boat> >::iterator it = s_boats.begin(); it != s_boats.end(); )
+        if(it->second.expired())
+            s_boats.erase(it++);
+        else
+            it++;
+
+    std::shared_ptr<Boat> boat = std::make_shared<Boat>();
+    wxString error = boat->OpenXML(boatFileName, false);
+    m_Boat = boat;
+    if(error.empty())
+        s_boats[boatFileName] = boat;
+    return error;
+}
+
 bool (*RouteMap::ClimatologyData)
 (int setting, const wxDateTime &, double, double, double &, double &) = NULL;
 bool (*RouteMap::ClimatologyWindAtlasData)(const wxDateTime &, double, double, int &count,
@@ -2572,12 +3380,16 @@ OD_FindClosestBoundaryLineCrossing RouteMap::ODFindClosestBoundaryLineCrossing =
 std::list<RouteMapPosition> RouteMap::Positions;
 
 RouteMap::RouteMap()
+    : m_PrefetchedSize(0), m_Origin(new IsoChronList), m_Propagation(m_Origin),
+      m_UpdatingFollower(NULL), m_FollowerUpdated(m_FollowersMutex),
+      m_bLeading(false), m_bCoarsePass(false)
 {
 }
 
 RouteMap::~RouteMap()
 {
     Clear();
+    ClearPrefetchedGribs();
 }
 
 void RouteMap::PositionLatLon(wxString Name, double &lat, double &lon)
@@ -2620,24 +3432,204 @@ bool RouteMap::ReduceList(IsoRouteList &merged, IsoRouteList &routelist, RouteMa
     return true;
 }
 
+/* a position sailed, by its parent and heading */
+typedef std::pair<Position*, double> SailedHeading;
+
+/* test the deferred positions left on a merged route and its children,
+   collecting those which failed */
+static void ValidatePositions(IsoRoute *r, std::map<SailedHeading, bool> &tested,
+                              std::set<SailedHeading> &rejected, RouteMapConfiguration &configuration)
+{
+    Position *p = r->skippoints->point;
+    do {
+        if(p->deferred) {
+            SailedHeading sailed(p->parent, p->parent_heading);
+            std::map<SailedHeading, bool>::iterator it = tested.find(sailed);
+            if(it == tested.end()) {
+                Position *parent = p->parent;
+                Geodesy origin(parent->lat, parent->lon, configuration.GeodesyMode);
+                double BG, dist;
+                origin.Reverse(p->lat, p->lon, &BG, &dist);
+                bool passed = !parent->Obstructed(p->lat, p->lon, BG, dist, origin, configuration);
+                it = tested.insert(std::pair<SailedHeading, bool>(sailed, passed)).first;
+            }
+            if(it->second)
+                p->deferred = false;
+            else
+                rejected.insert(sailed);
+        }
+        p = p->next;
+    } while(p != r->skippoints->point);
+
+    for(IsoRouteList::iterator it = r->children.begin(); it != r->children.end(); ++it)
+        ValidatePositions(*it, tested, rejected, configuration);
+}
+
+/* a route propagated from one position without those rejected, NULL if too few are left */
+static IsoRoute *RemoveRejected(IsoRoute *r, const std::set<SailedHeading> &rejected)
+{
+    std::vector<Position*> positions;
+    bool any = false;
+    Position *p = r->skippoints->point;
+    do {
+        positions.push_back(p);
+        if(p->deferred && rejected.count(SailedHeading(p->parent, p->parent_heading)))
+            any = true;
+        p = p->next;
+    } while(p != r->skippoints->point);
+
+    if(!any)
+        return r;
+
+    DeleteSkipPoints(r->skippoints);
+    r->skippoints = NULL; /* keep the positions */
+    delete r;
+
+    Position *points = NULL;
+    int count = 0;
+    for(std::vector<Position*>::iterator it = positions.begin(); it != positions.end(); ++it) {
+        Position *rp = *it;
+        if(rp->deferred && rejected.count(SailedHeading(rp->parent, rp->parent_heading))) {
+            delete rp;
+            continue;
+        }
+
+        if(points) {
+            rp->prev=points->prev;
+            rp->next=points;
+            points->prev->next = rp;
+            points->prev = rp;
+        } else {
+            rp->prev = rp->next = rp;
+            points = rp;
+        }
+        count++;
+    }
+
+    if(count < 3) {
+        if(count)
+            DeletePoints(points);
+        return NULL;
+    }
+
+    return new IsoRoute(points->BuildSkipList());
+}
+
+static IsoRoute *CopyRoute(IsoRoute *r, IsoRoute *parent = NULL)
+{
+    IsoRoute *c = new IsoRoute(r, parent);
+    for(IsoRouteList::iterator it = r->children.begin(); it != r->children.end(); ++it)
+        c->children.push_back(CopyRoute(*it, c));
+    return c;
+}
+
+/* merge copies of routes whose crossings are not tested yet, test only the positions
+   left on the merged routes, and merge again without those which failed until all pass */
+bool RouteMap::ReduceValidated(IsoRouteList &merged, IsoRouteList &routelist, RouteMapConfiguration &configuration)
+{
+    std::map<SailedHeading, bool> tested;
+    for(;;) {
+        IsoRouteList copies;
+        for(IsoRouteList::iterator it = routelist.begin(); it != routelist.end(); ++it)
+            copies.push_back(CopyRoute(*it));
+
+        if(!ReduceList(merged, copies, configuration))
+            break;
+
+        std::set<SailedHeading> rejected;
+        for(IsoRouteList::iterator it = merged.begin(); it != merged.end(); ++it)
+            ValidatePositions(*it, tested, rejected, configuration);
+        if(rejected.empty())
+            break;
+
+        for(IsoRouteList::iterator it = merged.begin(); it != merged.end(); ++it)
+            delete *it;
+        merged.clear();
+
+        for(IsoRouteList::iterator it = routelist.begin(); it != routelist.end(); ) {
+            IsoRoute *r = RemoveRejected(*it, rejected);
+            if(r)
+                *(it++) = r;
+            else
+                it = routelist.erase(it);
+        }
+    }
+
+    for(IsoRouteList::iterator it = routelist.begin(); it != routelist.end(); ++it)
+        delete *it;
+    routelist.clear();
+    return !TestAbort();
+}
+
 /* enlarge the map by 1 level */
 bool RouteMap::Propagate()
 {
-    Lock();
+    /* only this thread appends, so the snapshot stays current */
+    IsoChronSnapshot snapshot = std::atomic_load(&m_Propagation);
+    const IsoChronList &origin = *snapshot;
 
-    if(m_bNeedsGrib) { // waiting for timer in main thread to request the grib
-        Unlock();
-        return false;
+    std::shared_ptr<std::vector<std::pair<double, double> > > destinations;
+    {
+        wxMutexLocker followers_lock(m_FollowersMutex);
+        if(!m_Followers.empty()) {
+            destinations = std::make_shared<std::vector<std::pair<double, double> > >();
+            for(std::list<RouteMap*>::iterator it = m_Followers.begin(); it != m_Followers.end(); it++) {
+                (*it)->Lock();
+                destinations->push_back(std::make_pair((*it)->m_Configuration.EndLat,
+                                                       (*it)->m_Configuration.EndLon));
+                (*it)->Unlock();
+            }
+        }
     }
 
+    Lock();
+
     if(!m_bValid) { /* config change */
         m_bFinished = true;
         Unlock();
         return false;
     }
 
+    Shared_GribRecordSet shared_grib;
+    if(m_bNeedsGrib) {
+        /* drop gribs for times already propagated */
+        while(!m_PrefetchedGribs.empty() && m_PrefetchedGribs.front().time < m_NewTime)
+            PopPrefetchedGrib();
+
+        if(m_PrefetchedGribs.empty()) { // waiting for timer in main thread to request the grib
+            if(m_GribRequestTime > m_NewTime)
+                m_GribRequestTime = m_NewTime;
+            Unlock();
+            return false;
+        }
+
+        if(m_PrefetchedGribs.front().time != m_NewTime) {
+            /* requests got out of step with the propagation, start over */
+            ClearPrefetchedGribs();
+            m_GribRequestTime = m_NewTime;
+            Unlock();
+            return false;
+        }
+
+        shared_grib = m_PrefetchedGribs.front().grib;
+        PopPrefetchedGrib();
+    }
+    WR_GribRecordSet *newgrib = shared_grib.GetGribRecordSet();
+
     //
     RouteMapConfiguration configuration = m_Configuration;
+    double EndLat = configuration.EndLat, EndLon = configuration.EndLon;
+    if(m_bCoarsePass)
+        configuration.CoarsenDegreeSteps(COARSE_DEGREE_FACTOR);
+    configuration.corridor = m_Corridor;
+    if(m_bLeading) {
+        /* the isochrons must serve every destination */
+        configuration.MaxCourseAngle = configuration.MaxDivertedCourse = 180;
+        configuration.FollowerDestinations = destinations;
+    }
+    bool visible = !m_bReachedDestination && !m_bCoarsePass;
+    if(!configuration.DetectLand && !configuration.DetectBoundary && !configuration.AvoidCycloneTracks)
+        configuration.DeferValidation = false; /* nothing to test */
     configuration.polar_failed = false;
     configuration.wind_data_failed = false;
     configuration.boundary_crossing = false;
@@ -2647,26 +3639,23 @@ bool RouteMap::Propagate()
     bool grib_is_data_deficient = false;
         
     if(m_Configuration.AllowDataDeficient &&
-        ( !m_NewGrib ||
-          !m_NewGrib->m_GribRecordPtrArray[Idx_WIND_VX] ||
-          !m_NewGrib->m_GribRecordPtrArray[Idx_WIND_VY]
+        ( !newgrib ||
+          !newgrib->m_GribRecordPtrArray[Idx_WIND_VX] ||
+          !newgrib->m_GribRecordPtrArray[Idx_WIND_VY]
         ) && origin.size() &&
        /*m_Configuration.ClimatologyType <= RouteMapConfiguration::CURRENTS_ONLY &&*/
        m_Configuration.UseGrib) {
-        SetNewGrib(origin.back()->m_Grib);
+        /* keep using the previous grib */
+        shared_grib = origin.back()->m_SharedGrib;
         grib_is_data_deficient = true;
     }
 
-    Shared_GribRecordSet shared_grib = m_SharedNewGrib;
     wxDateTime time = m_NewTime;
     double delta;
 
-    m_NewGrib = 0;
-    m_SharedNewGrib.SetGribRecordSet(0);
-
-    // request the next grib
+    // the next grib is requested (or already was)
     // in a different thread (grib record averaging going in parallel)
-    delta = configuration.DeltaTime;
+    delta = DeltaTime();
     m_NewTime += wxTimeSpan(0, 0, delta);
     m_bNeedsGrib = configuration.UseGrib;
 
@@ -2683,6 +3672,17 @@ bool RouteMap::Propagate()
         configuration.time = origin.back()->time;
         configuration.UsedDeltaTime = origin.back()->delta;
         configuration.grib_is_data_deficient = origin.back()->m_Grib_is_data_deficient;
+        if(!m_bLeading && configuration.MaxPassageHours > 0) {
+            /* time to go is at least the distance at the fastest speed over ground,
+               allow a percent for the spherical distance underestimating the ellipsoid.
+               The currents of the gribs still to come are not known, they are bounded
+               by those of the loaded grib like the legs to the destination are */
+            wxDateTime arrival = configuration.StartTime + wxTimeSpan::Seconds(configuration.MaxPassageHours*3600);
+            double seconds = (arrival - configuration.time).GetSeconds().ToDouble();
+            double maxspeed = MaxSpeedOverGround(configuration);
+            if(!std::isinf(maxspeed))
+                configuration.GoalRange = maxspeed * seconds / 3600 * 1.01;
+        }
         // will the grib data work for us?
         if(m_Configuration.UseGrib &&
            (!configuration.grib ||
@@ -2691,8 +3691,12 @@ bool RouteMap::Propagate()
            (!RouteMap::ClimatologyData ||
             m_Configuration.ClimatologyType <= RouteMapConfiguration::CURRENTS_ONLY )) {
             Lock();
-            m_bFinished = true;
-            m_bGribFailed = true;
+            if(m_bCoarsePass)
+                StartFinePass(NULL);
+            else {
+                m_bFinished = true;
+                m_bGribFailed = true;
+            }
             Unlock();
             return false;
         }
@@ -2705,7 +3709,8 @@ bool RouteMap::Propagate()
         update = NULL;
     } else {
         IsoRouteList merged;
-        if(!ReduceList(merged, routelist, configuration))
+        if(!(configuration.DeferValidation ? ReduceValidated(merged, routelist, configuration)
+             : ReduceList(merged, routelist, configuration)))
             return false;
 
         for(IsoRouteList::iterator it = merged.begin(); it != merged.end(); ++it)
@@ -2714,12 +3719,39 @@ bool RouteMap::Propagate()
         update = new IsoChron(merged, time, delta, shared_grib, grib_is_data_deficient);
     }
 
+    bool reached = update && update->Contains(EndLat, EndLon);
+
+    /* the best position is near the edge of the corridor, the route may want to leave it */
+    std::shared_ptr<const RouteCorridor> corridor = configuration.corridor;
+    if(update && corridor && !reached) {
+        Position *best = update->ClosestPosition(EndLat, EndLon);
+        if(best && corridor->Distance(best->lat, best->lon) > corridor->range * CORRIDOR_EDGE) {
+            RouteCorridor *wider = new RouteCorridor(*corridor);
+            wider->range *= 2;
+            Lock();
+            if(m_Corridor == corridor)
+                m_Corridor = std::shared_ptr<const RouteCorridor>(wider);
+            else
+                delete wider;
+            Unlock();
+        }
+    }
+
+    if(update && !Publish(snapshot, update, visible))
+        return false;
+
     Lock();
+    if(m_bCoarsePass) {
+        /* without a coarse route the fine pass propagates everywhere */
+        if(!update || reached)
+            StartFinePass(update);
+        Unlock();
+        return true;
+    }
+
     if(update) {
-        origin.push_back(update);
-        if(update->Contains(m_Configuration.EndLat, m_Configuration.EndLon)) {
-            SetFinished(true);
-        }
+        if(reached)
+            m_bReachedDestination = true;
     } else
         m_bFinished = true;
 
@@ -2728,11 +3760,166 @@ bool RouteMap::Propagate()
 
     Unlock();
 
+    /* followers find their destination without this map locked */
+    if(update)
+        UpdateFollowers(std::atomic_load(&m_Propagation), configuration);
+
     return true;
 }
 
+/* start over at the configured resolution near the route to the position of
+   the coarse isochron closest to the destination, or anywhere without one */
+void RouteMap::StartFinePass(IsoChron *coarse)
+{
+    if(coarse) {
+        RouteCorridor *corridor = new RouteCorridor;
+        corridor->lats.push_back(m_Configuration.EndLat);
+        corridor->lons.push_back(m_Configuration.EndLon);
+        for(Position *p = coarse->ClosestPosition(m_Configuration.EndLat, m_Configuration.EndLon);
+            p; p = p->parent) {
+            corridor->lats.push_back(p->lat);
+            corridor->lons.push_back(p->lon);
+        }
+        corridor->range = m_Configuration.CorridorMiles;
+        m_Corridor = std::shared_ptr<const RouteCorridor>(corridor);
+    }
+
+    /* frees the coarse isochrons, readers never saw them */
+    IsoChronSnapshot empty(new IsoChronList);
+    std::atomic_store(&m_Propagation, empty);
+    std::atomic_store(&m_Origin, empty);
+
+    m_bCoarsePass = false;
+    ClearPrefetchedGribs();
+    m_NewTime = m_Configuration.StartTime;
+    m_GribRequestTime = m_NewTime;
+    m_bNeedsGrib = m_Configuration.UseGrib;
+}
+
+/* append a new isochron, for readers too if visible, false if the map was cleared meanwhile */
+bool RouteMap::Publish(IsoChronSnapshot snapshot, IsoChron *update, bool visible)
+{
+    std::shared_ptr<IsoChronList> published(new IsoChronList(*snapshot));
+    published->push_back(std::shared_ptr<IsoChron>(update));
+
+    IsoChronSnapshot expected = snapshot;
+    if(!std::atomic_compare_exchange_strong(&m_Propagation, &expected, IsoChronSnapshot(published)))
+        return false;
+
+    /* until the destination is reached readers see every isochron propagated */
+    expected = snapshot;
+    return !visible ||
+        std::atomic_compare_exchange_strong(&m_Origin, &expected, IsoChronSnapshot(published));
+}
+
+void RouteMap::AddFollower(RouteMap *follower)
+{
+    wxMutexLocker followers_lock(m_FollowersMutex);
+    Lock();
+    m_Followers.push_back(follower);
+    m_bLeading = true;
+    m_bCoarsePass = false; /* followers need every isochron of one pass */
+    Unlock();
+}
+
+/* waits only if the destination of this follower is being updated */
+void RouteMap::RemoveFollower(RouteMap *follower)
+{
+    wxMutexLocker followers_lock(m_FollowersMutex);
+    m_Followers.remove(follower);
+    for(std::list<std::pair<RouteMap*, bool> >::iterator it = m_PendingFollowers.begin();
+        it != m_PendingFollowers.end(); )
+        if(it->first == follower)
+            it = m_PendingFollowers.erase(it);
+        else
+            it++;
+
+    while(m_UpdatingFollower == follower)
+        m_FollowerUpdated.Wait();
+}
+
+/* followers left once this map stops propagating did not reach their destination */
+void RouteMap::ReleaseFollowers()
+{
+    wxMutexLocker followers_lock(m_FollowersMutex);
+    Lock();
+    bool grib_failed = m_bGribFailed;
+    Unlock();
+
+    for(std::list<RouteMap*>::iterator it = m_Followers.begin(); it != m_Followers.end(); it++) {
+        RouteMap *follower = *it;
+        follower->Lock();
+        if(grib_failed)
+            follower->m_bGribFailed = true;
+        follower->m_bFinished = true;
+        follower->Unlock();
+    }
+    m_Followers.clear();
+    m_PendingFollowers.clear();
+}
+
+/* followers see the isochrons propagated so far, those reaching their destination
+   keep the isochrons up to it and are finished, once none are left and this map
+   reached its own destination it is finished too.  Called unlocked so readers of
+   this map do not wait while followers propagate to their destination, and each
+   follower is updated with m_FollowersMutex released so removing another follower
+   does not wait either, only the one being updated can not be removed meanwhile */
+void RouteMap::UpdateFollowers(IsoChronSnapshot snapshot, const RouteMapConfiguration &configuration)
+{
+    m_FollowersMutex.Lock();
+    if(snapshot->empty()) {
+        m_FollowersMutex.Unlock();
+        return; /* cleared meanwhile */
+    }
+
+    IsoChron *update = snapshot->back().get();
+    for(std::list<RouteMap*>::iterator it = m_Followers.begin(); it != m_Followers.end(); ) {
+        RouteMap *follower = *it;
+        follower->Lock();
+        bool reached = update->Contains(follower->m_Configuration.EndLat,
+                                        follower->m_Configuration.EndLon);
+        std::atomic_store(&follower->m_Origin, snapshot);
+        std::atomic_store(&follower->m_Propagation, snapshot);
+        follower->UpdateStatus(configuration);
+        follower->Unlock();
+
+        m_PendingFollowers.push_back(std::make_pair(follower, reached));
+        if(reached)
+            it = m_Followers.erase(it);
+        else
+            it++;
+    }
+
+    while(!m_PendingFollowers.empty()) {
+        RouteMap *follower = m_UpdatingFollower = m_PendingFollowers.front().first;
+        bool reached = m_PendingFollowers.front().second;
+        m_PendingFollowers.pop_front();
+        m_FollowersMutex.Unlock();
+
+        FollowerUpdated(follower);
+        /* finished only once its destination is known */
+        if(reached) {
+            follower->Lock();
+            follower->SetFinished(true);
+            follower->Unlock();
+        }
+
+        m_FollowersMutex.Lock();
+        m_UpdatingFollower = NULL;
+        m_FollowerUpdated.Broadcast();
+    }
+
+    Lock();
+    if(m_bReachedDestination && m_Followers.empty())
+        SetFinished(true);
+    Unlock();
+    m_FollowersMutex.Unlock();
+}
+
 Position *RouteMap::ClosestPosition(double lat, double lon, wxDateTime *t, double *d)
 {
+    IsoChronSnapshot snapshot = Origin();
+    const IsoChronList &origin = *snapshot;
     if(origin.empty())
         return NULL;
 
@@ -2742,10 +3929,12 @@ Position *RouteMap::ClosestPosition(double lat, double lon, wxDateTime *t, doubl
     bool first = (t !=0);
     wxDateTime min_t;
     Lock();
+    bool positive_longitudes = m_Configuration.positive_longitudes;
+    Unlock();
 
-    IsoChronList::iterator it = origin.end();
+    IsoChronList::const_iterator it = origin.end();
 
-    Position p(lat, m_Configuration.positive_longitudes ? positive_degrees(lon) : lon);
+    Position p(lat, positive_longitudes ? positive_degrees(lon) : lon);
     do {
         it--;
         double dist;
@@ -2771,8 +3960,6 @@ Position *RouteMap::ClosestPosition(double lat, double lon, wxDateTime *t, doubl
             first = false;
     } while(it != origin.begin());
 
-    Unlock();
-
     if(d)
         *d = mindist;
     if(t)
@@ -2780,6 +3967,18 @@ Position *RouteMap::ClosestPosition(double lat, double lon, wxDateTime *t, doubl
     return minpos;
 }
 
+wxString RouteMap::LoadBoat()
+{
+    /* load without holding the lock, the configuration copy is cheap */
+    RouteMapConfiguration configuration = GetConfiguration();
+    wxString error = configuration.LoadBoat();
+
+    Lock();
+    m_Configuration.ShareBoat(configuration);
+    Unlock();
+    return error;
+}
+
 void RouteMap::Reset()
 {
     Lock();
@@ -2787,8 +3986,11 @@ void RouteMap::Reset()
 
     m_NewGrib = NULL;
     m_SharedNewGrib.SetGribRecordSet(0);
+
+    ClearPrefetchedGribs();
     
     m_NewTime = m_Configuration.StartTime;
+    m_GribRequestTime = m_NewTime;
     m_bNeedsGrib = m_Configuration.UseGrib && m_Configuration.RouteGUID.IsEmpty();
     m_ErrorMsg = wxEmptyString;
 
@@ -2799,10 +4001,116 @@ void RouteMap::Reset()
     m_bFinished = false;
     m_bLandCrossing = false;
     m_bBoundaryCrossing = false;
+    m_bLeading = false;
+
+    m_bCoarsePass = m_Configuration.CorridorMiles > 0 && m_Configuration.RouteGUID.IsEmpty();
+    m_Corridor.reset();
 
     Unlock();
 }
 
+/* approximate memory held by a grib copied in SetNewGrib */
+static size_t GribMemorySize(WR_GribRecordSet *grib)
+{
+    if(!grib)
+        return 0;
+
+    size_t size = sizeof *grib;
+    for(int i=0; i<Idx_COUNT; i++) {
+        GribRecord *rec = grib->m_GribRecordPtrArray[i];
+        if(rec)
+            size += sizeof *rec + rec->getNi()*rec->getNj()*sizeof(double);
+    }
+
+    if(grib->m_Tile) {
+        GribRecord *rec = grib->m_GribRecordPtrArray[Idx_WIND_VX];
+        size += rec->getNi()*rec->getNj()*GribTile::FIELDS*sizeof(float);
+    }
+    return size;
+}
+
+/* limit the memory used for gribs waiting to be propagated, by all route maps together */
+#define MAX_PREFETCH_SIZE (256*1024*1024)
+
+void RouteMap::PopPrefetchedGrib()
+{
+    size_t size = m_PrefetchedGribs.front().size;
+    m_PrefetchedGribs.pop_front();
+    m_PrefetchedSize -= size;
+
+    wxMutexLocker lock(s_key_mutex);
+    s_prefetched_size -= size;
+}
+
+void RouteMap::ClearPrefetchedGribs()
+{
+    size_t size = m_PrefetchedSize;
+    m_PrefetchedGribs.clear();
+    m_PrefetchedSize = 0;
+
+    wxMutexLocker lock(s_key_mutex);
+    s_prefetched_size -= size;
+}
+
+bool RouteMap::NeedsGrib()
+{
+    Lock();
+    /* the propagation is waiting */
+    bool needsgrib = m_bNeedsGrib && m_PrefetchedGribs.empty();
+
+    /* or request ahead while it is busy */
+    if(!needsgrib && m_Configuration.UseGrib && m_bValid &&
+       (int)m_PrefetchedGribs.size() < m_Configuration.PrefetchDepth) {
+        wxMutexLocker lock(s_key_mutex);
+        needsgrib = s_prefetched_size < MAX_PREFETCH_SIZE;
+    }
+    Unlock();
+    return needsgrib;
+}
+
+/* called by the main thread after requesting the grib for time, the GribRequestTime()
+   it read, if one was received SetNewGrib was already called with it, returns the grib */
+Shared_GribRecordSet RouteMap::RequestedGrib(const wxDateTime &time)
+{
+    Lock();
+    if(time != m_GribRequestTime) {
+        /* the propagation started over since, the grib is for another time */
+        Shared_GribRecordSet grib = m_SharedNewGrib;
+        m_NewGrib = 0;
+        m_SharedNewGrib.SetGribRecordSet(0);
+        Unlock();
+        return grib;
+    }
+
+    if(m_GribRequestTime < m_NewTime)
+        m_GribRequestTime = m_NewTime;
+
+    PrefetchedGrib prefetched;
+    prefetched.time = m_GribRequestTime;
+    prefetched.grib = m_SharedNewGrib;
+    prefetched.size = GribMemorySize(m_NewGrib);
+    m_PrefetchedGribs.push_back(prefetched);
+    m_PrefetchedSize += prefetched.size;
+    {
+        wxMutexLocker lock(s_key_mutex);
+        s_prefetched_size += prefetched.size;
+    }
+
+    m_NewGrib = 0;
+    m_SharedNewGrib.SetGribRecordSet(0);
+
+    m_GribRequestTime += wxTimeSpan(0, 0, DeltaTime());
+    Unlock();
+    return prefetched.grib;
+}
+
+/* a grib another route map received for the same time, instead of requesting it */
+void RouteMap::SetSharedGrib(const Shared_GribRecordSet &grib)
+{
+    m_SharedNewGrib = grib;
+    m_NewGrib = m_SharedNewGrib.GetGribRecordSet();
+}
+
 void RouteMap::SetNewGrib(GribRecordSet *grib)
 {
     if(!grib ||
@@ -2849,6 +4157,7 @@ void RouteMap::SetNewGrib(GribRecordSet *grib)
             break;
         }
     }
+    m_NewGrib->BuildTile();
     m_SharedNewGrib.SetGribRecordSet(m_NewGrib);
 }
 
@@ -2890,24 +4199,24 @@ void RouteMap::SetNewGrib(WR_GribRecordSet *grib)
             break;
         }
     }
+    m_NewGrib->BuildTile();
     m_SharedNewGrib.SetGribRecordSet(m_NewGrib);
 }
 
 void RouteMap::GetStatistics(int &isochrons, int &routes, int &invroutes, int &skippositions, int &positions)
 {
-    Lock();
-    isochrons = origin.size();
+    IsoChronSnapshot origin = Origin();
+    isochrons = origin->size();
     routes = invroutes = skippositions = positions = 0;
-    for(IsoChronList::iterator it = origin.begin(); it != origin.end(); ++it)
+    for(IsoChronList::const_iterator it = origin->begin(); it != origin->end(); ++it)
         for(IsoRouteList::iterator rit = (*it)->routes.begin(); rit != (*it)->routes.end(); ++rit)
             (*rit)->UpdateStatistics(routes, invroutes, skippositions, positions);
-    Unlock();
 }
 
+/* isochrons are freed once no reader holds a snapshot with them */
 void RouteMap::Clear()
 {
-    for(IsoChronList::iterator it = origin.begin(); it != origin.end(); ++it)
-        delete *it;
-
-    origin.clear();
+    IsoChronSnapshot empty(new IsoChronList);
+    std::atomic_store(&m_Propagation, empty);
+    std::atomic_store(&m_Origin, empty);
 }
@@ -72,15 +72,17 @@ void *RouteMapOverlayThread::Entry()
             wxThread::Sleep(5);
         }
     }
+    m_RouteMapOverlay.ReleaseFollowers();
 //    m_RouteMapOverlay.m_Thread = NULL;
     return 0;
 }
 
 RouteMapOverlay::RouteMapOverlay()
-    : m_UpdateOverlay(true), m_bEndRouteVisible(false), m_Thread(NULL),
+    : m_UpdateOverlay(true), m_bEndRouteVisible(false), m_Thread(NULL), m_Leader(NULL),
       last_cursor_lat(0), last_cursor_lon(0),
       last_cursor_position(NULL), destination_position(NULL), last_destination_position(NULL),
-      m_bUpdated(false), m_overlaylist(0),
+      m_DestinationDelta(NAN), m_bUpdated(false), m_overlaylist(0),
+      m_IsoChronLinesLat(NAN), m_IsoChronLinesLon(NAN),
       clear_destination_plotdata(false),
       wind_barb_cache_scale(NAN),
       wind_barb_cache_origin_size(0),
@@ -95,6 +97,14 @@ RouteMapOverlay::~RouteMapOverlay()
 
     if(m_Thread)
         Stop();
+
+    Unfollow();
+    for(std::list<RouteMapOverlay*>::iterator it = m_FollowerOverlays.begin();
+        it != m_FollowerOverlays.end(); it++) {
+        RemoveFollower(*it);
+        (*it)->m_Leader = NULL;
+        (*it)->Stop();
+    }
 }
 
 bool RouteMapOverlay::Start(wxString &error)
@@ -169,16 +179,17 @@ void RouteMapOverlay::RouteAnalysis(PlugIn_Route *proute)
         if (pwpnode == nullptr)
             break;
 
-        int data_mask = 0;
+        int data_mask = 0, newpolar;
         double H;
         pwp = pwpnode->GetData();
         rte.lat = pwp->m_lat, rte.lon = pwp->m_lon;
         next = &rte;
-        eta = data.PropagateToPoint(rte.lat, rte.lon, configuration, H, data_mask, false);
+        eta = data.PropagateToPoint(rte.lat, rte.lon, configuration, H, data_mask, newpolar, false);
         if(std::isnan(eta)) {
             ok = false;
             eta = dt;
-        }
+        } else
+            data.polar = newpolar;
         // ll_gc_ll_reverse(data.lat, data.lon, next->lat, next->lon, &data.BG, &data.VBG);
         curtime += wxTimeSpan(0, 0, eta);
         if (!configuration.wind_data_failed) {
@@ -196,6 +207,7 @@ void RouteMapOverlay::RouteAnalysis(PlugIn_Route *proute)
                                             nullptr, /*minH*/ NAN, NAN, data.polar, true , 0);
 
     last_cursor_plotdata = last_destination_plotdata;
+    m_RouteSummary[0].valid = m_RouteSummary[1].valid = false;
     if (ok) {
         m_EndTime = data.time;
     }
@@ -214,6 +226,29 @@ void RouteMapOverlay::DeleteThread()
     m_Thread = NULL;
 }
 
+void RouteMapOverlay::Follow(RouteMapOverlay *leader)
+{
+    m_Leader = leader;
+    leader->m_FollowerOverlays.push_back(this);
+    leader->AddFollower(this);
+}
+
+void RouteMapOverlay::Unfollow()
+{
+    if(!m_Leader)
+        return;
+
+    m_Leader->RemoveFollower(this);
+    m_Leader->m_FollowerOverlays.remove(this);
+    m_Leader = NULL;
+}
+
+/* called from the leader's thread */
+void RouteMapOverlay::FollowerUpdated(RouteMap *follower)
+{
+    static_cast<RouteMapOverlay*>(follower)->UpdateDestination();
+}
+
 static void SetColor(piDC &dc, wxColour c, bool penifgl = false)
 {
 #ifndef __OCPN__ANDROID__
@@ -352,12 +387,188 @@ void RouteMapOverlay::RenderIsoRoute(IsoRoute *r, wxColour &grib_color, wxColour
         RenderIsoRoute(*it, cyan, magenta, dc, vp);
 }
 
+#define LOD_TOLERANCE 250 /* meters */
+#define LOD_FACTOR 4
+
+static double LODTolerance(int level)
+{
+    return level ? LOD_TOLERANCE * pow(LOD_FACTOR, level - 1) : 0;
+}
+
+/* douglas-peucker between points already kept at a and b on a closed line */
+static void DecimateLine(const std::vector<double> &x, const std::vector<double> &y,
+                         int a, int b, double tolerance, std::vector<bool> &keep)
+{
+    int n = x.size();
+    std::list<std::pair<int, int> > spans;
+    spans.push_back(std::pair<int, int>(a, b));
+    while(!spans.empty()) {
+        a = spans.back().first, b = spans.back().second;
+        spans.pop_back();
+
+        double dx = x[b] - x[a], dy = y[b] - y[a], d = sqrt(dx*dx + dy*dy);
+        double maxdist = tolerance;
+        int maxi = -1;
+        for(int i = (a+1)%n; i != b; i = (i+1)%n) {
+            double ix = x[i] - x[a], iy = y[i] - y[a];
+            double dist = d > 0 ? fabs(ix*dy - iy*dx) / d : sqrt(ix*ix + iy*iy);
+            if(dist > maxdist)
+                maxdist = dist, maxi = i;
+        }
+
+        if(maxi != -1) {
+            keep[maxi] = true;
+            spans.push_back(std::pair<int, int>(a, maxi));
+            spans.push_back(std::pair<int, int>(maxi, b));
+        }
+    }
+}
+
+void RouteMapOverlay::PushIsoRouteLines(IsoRoute *r, wxColour &grib_color, wxColour &climatology_color,
+                                        IsoChronLines &lines)
+{
+    SkipPosition *s = r->skippoints;
+    if(!s)
+        return;
+
+    wxColour grib_deficient_color = TransparentColor(grib_color);
+    wxColour climatology_deficient_color = TransparentColor(climatology_color);
+
+    std::vector<double> x, y;
+    std::vector<wxColour> colors;
+    std::vector<bool> skipped; /* segment from this point is not drawn */
+    Position *p = s->point;
+    do {
+        double px, py;
+        toSM(p->lat, p->lon, m_IsoChronLinesLat, m_IsoChronLinesLon, &px, &py);
+        x.push_back(px), y.push_back(py);
+        colors.push_back(PositionColor(p, grib_color, climatology_color,
+                                       grib_deficient_color, climatology_deficient_color));
+        skipped.push_back(p->copied && p->next->copied);
+        p = p->next;
+    } while(p != s->point);
+
+    /* always keep the ends of skipped segments and where colors change */
+    int n = x.size();
+    std::vector<bool> fixed(n, false);
+    for(int i = 0; i < n; i++) {
+        int j = (i+1)%n;
+        if(skipped[i] || colors[i] != colors[j])
+            fixed[i] = fixed[j] = true;
+    }
+
+    int first = -1;
+    for(int i = 0; i < n && first == -1; i++)
+        if(fixed[i])
+            first = i;
+    if(first == -1) {
+        first = 0;
+        fixed[0] = fixed[n/2] = true;
+    }
+
+    for(int level = 0; level < LOD_LEVELS; level++) {
+        std::vector<bool> keep = fixed;
+        if(level == 0)
+            keep.assign(n, true);
+        else {
+            int a = first;
+            do {
+                int b = (a+1)%n;
+                while(!fixed[b])
+                    b = (b+1)%n;
+                DecimateLine(x, y, a, b, LODTolerance(level), keep);
+                a = b;
+            } while(a != first);
+        }
+
+        std::vector<float> &vertices = lines.vertices[level];
+        std::vector<unsigned char> &lcolors = lines.colors[level];
+        int a = first;
+        do {
+            int b = (a+1)%n;
+            while(!keep[b])
+                b = (b+1)%n;
+
+            if(!(b == (a+1)%n && skipped[a]))
+                for(int k = 0; k < 2; k++) {
+                    int i = k ? b : a;
+                    vertices.push_back(x[i]);
+                    vertices.push_back(y[i]);
+                    lcolors.push_back(colors[i].Red());
+                    lcolors.push_back(colors[i].Green());
+                    lcolors.push_back(colors[i].Blue());
+                    lcolors.push_back(colors[i].Alpha());
+                }
+            a = b;
+        } while(a != first);
+    }
+
+    wxColour cyan(0, 255, 255), magenta(255, 0, 255);
+    for(IsoRouteList::iterator it = r->children.begin(); it != r->children.end(); ++it)
+        PushIsoRouteLines(*it, cyan, magenta, lines);
+}
+
+void RouteMapOverlay::DrawIsoChronLines(PlugIn_ViewPort &vp)
+{
+#if defined(ocpnUSE_GL) && !defined(__OCPN__ANDROID__)
+    /* mercator meters map linearly to the screen, so find the transform
+       from where the viewport puts points about 100 pixels apart */
+    double d = 100 / vp.view_scale_ppm, lat, lon;
+    wxPoint2DDouble o, x, y;
+    GetDoubleCanvasPixLL(&vp, &o, m_IsoChronLinesLat, m_IsoChronLinesLon);
+    fromSM(d, 0, m_IsoChronLinesLat, m_IsoChronLinesLon, &lat, &lon);
+    GetDoubleCanvasPixLL(&vp, &x, lat, lon);
+    fromSM(0, d, m_IsoChronLinesLat, m_IsoChronLinesLon, &lat, &lon);
+    GetDoubleCanvasPixLL(&vp, &y, lat, lon);
+
+    GLdouble m[16] = {(x.m_x - o.m_x)/d, (x.m_y - o.m_y)/d, 0, 0,
+                      (y.m_x - o.m_x)/d, (y.m_y - o.m_y)/d, 0, 0,
+                      0, 0, 1, 0,
+                      o.m_x, o.m_y, 0, 1};
+
+    /* coarsest level which stays within half a pixel */
+    int level = 0;
+    while(level + 1 < LOD_LEVELS && LODTolerance(level + 1) * vp.view_scale_ppm < .5)
+        level++;
+
+    glPushMatrix();
+    glMultMatrixd(m);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+
+    for(std::list<IsoChronLines>::iterator it = m_IsoChronLines.begin();
+        it != m_IsoChronLines.end(); it++) {
+        std::vector<float> &vertices = it->vertices[level];
+        if(vertices.empty())
+            continue;
+        glVertexPointer(2, GL_FLOAT, 0, &vertices[0]);
+        glColorPointer(4, GL_UNSIGNED_BYTE, 0, &it->colors[level][0]);
+        glDrawArrays(GL_LINES, 0, vertices.size() / 2);
+    }
+
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glPopMatrix();
+#endif
+}
+
 void RouteMapOverlay::RenderAlternateRoute(IsoRoute *r, bool each_parent,
                                            piDC &dc, PlugIn_ViewPort &vp)
 {
     Position *pos = r->skippoints->point;
     wxColor black = wxColour(0, 0, 0, 192), tblack = TransparentColor(black);
+    wxPoint last;
+    bool first = true;
     do {
+        /* when zoomed out many positions share a pixel, one route from there is enough */
+        wxPoint point;
+        WR_GetCanvasPixLL(&vp, &point, pos->lat, pos->lon);
+        if(!first && point == last) {
+            pos = pos->next;
+            continue;
+        }
+        last = point, first = false;
+
         wxColour *color = pos->data_mask & Position::DATA_DEFICIENT_WIND ? &tblack : &black;
         for(Position *p = pos; p && !p->drawn && p->parent; p = p->parent) {
 //            wxColour &color = p->data_mask & Position::DATA_DEFICIENT_WIND ? tblack : black;
@@ -459,8 +670,9 @@ void RouteMapOverlay::Render(wxDateTime time, SettingsDialog &settingsdialog,
             /* draw alternate routes first */
             int AlternateRouteThickness = settingsdialog.m_sAlternateRouteThickness->GetValue();
             if(AlternateRouteThickness) {
-                Lock();
-                IsoChronList::iterator it;
+                IsoChronSnapshot snapshot = Origin();
+                const IsoChronList &origin = *snapshot;
+                IsoChronList::const_iterator it;
 
                 /* reset drawn flag for all positions
                    this is used to avoid duplicating alternate route segments */
@@ -490,7 +702,6 @@ void RouteMapOverlay::Render(wxDateTime time, SettingsDialog &settingsdialog,
                 if(!dc.GetDC())
                     glEnd();
 #endif
-                Unlock();
             }
 
             static const unsigned char routecolors[][3] = {
@@ -513,22 +724,44 @@ void RouteMapOverlay::Render(wxDateTime time, SettingsDialog &settingsdialog,
             int IsoChronThickness = settingsdialog.m_sIsoChronThickness->GetValue();
             if(IsoChronThickness) {
                 SetWidth(dc, IsoChronThickness);
-                Lock();
+
+                /* with opengl on mercator, isochrons already drawn keep their lines */
+#if defined(ocpnUSE_GL) && !defined(__OCPN__ANDROID__)
+                bool retained = !dc.GetDC() && !use_dl && vp.m_projection_type == PI_PROJECTION_MERCATOR;
+#else
+                bool retained = false;
+#endif
+                IsoChronSnapshot snapshot = Origin();
+                const IsoChronList &origin = *snapshot;
+                if(retained && m_IsoChronLines.empty()) {
+                    m_IsoChronLinesLat = configuration.StartLat;
+                    m_IsoChronLinesLon = configuration.StartLon;
+                }
+
+                std::list<IsoChronLines>::iterator l = m_IsoChronLines.begin();
                 int c = 0;
-                for(IsoChronList::iterator i = origin.begin(); i != origin.end(); ++i) {
-                    Unlock();
+                for(IsoChronList::const_iterator i = origin.begin(); i != origin.end(); ++i) {
                     wxColor grib_color(routecolors[c][0], routecolors[c][1], routecolors[c][2], 224);
                     wxColor climatology_color(255-routecolors[c][0], routecolors[c][2],
                                               routecolors[c][1], 224);
 
-                    for(IsoRouteList::iterator j = (*i)->routes.begin(); j != (*i)->routes.end(); ++j)
-                        RenderIsoRoute(*j, grib_color, climatology_color, dc, nvp);
+                    if(retained) {
+                        if(l == m_IsoChronLines.end()) {
+                            l = m_IsoChronLines.insert(l, IsoChronLines());
+                            for(IsoRouteList::iterator j = (*i)->routes.begin(); j != (*i)->routes.end(); ++j)
+                                PushIsoRouteLines(*j, grib_color, climatology_color, *l);
+                        }
+                        l++;
+                    } else
+                        for(IsoRouteList::iterator j = (*i)->routes.begin(); j != (*i)->routes.end(); ++j)
+                            RenderIsoRoute(*j, grib_color, climatology_color, dc, nvp);
 
                     if(++c == (sizeof routecolors) / (sizeof *routecolors))
                         c = 0;
-                    Lock();
                 }
-                Unlock();
+
+                if(retained)
+                    DrawIsoChronLines(vp);
             }
 
 #ifndef __OCPN__ANDROID__
@@ -741,7 +974,8 @@ void RouteMapOverlay::RenderCourse(bool cursor_route, piDC &dc, PlugIn_ViewPort
     if(!pos)
         return;
 
-    Lock();
+    /* keeps the positions alive while walking their parents */
+    IsoChronSnapshot snapshot = Origin();
 
     bool rte = !GetConfiguration().RouteGUID.IsEmpty();
     if (cursor_route == true) {
@@ -759,10 +993,8 @@ void RouteMapOverlay::RenderCourse(bool cursor_route, piDC &dc, PlugIn_ViewPort
                 glEnd();
 #endif
         }
-        Unlock();
         return;
     }
-    Unlock();
 
     /* ComfortDisplay Customization
      * ------------------------------------------------
@@ -975,6 +1207,8 @@ void RouteMapOverlay::RenderWindBarbsOnRoute(piDC &dc, PlugIn_ViewPort &vp, int
 
 void RouteMapOverlay::RenderWindBarbs(piDC &dc, PlugIn_ViewPort &vp)
 {
+    IsoChronSnapshot snapshot = Origin();
+    const IsoChronList &origin = *snapshot;
     if(origin.size() < 2) // no map to work with
         return;
 
@@ -1028,13 +1262,11 @@ void RouteMapOverlay::RenderWindBarbs(piDC &dc, PlugIn_ViewPort &vp)
             nvp = vp;
         }
 
-        Lock();
-
         wxPoint p;
         WR_GetCanvasPixLL( &nvp, &p, configuration.StartLat, configuration.StartLon );
         int xoff = p.x%(int)step, yoff = p.y%(int)step;
 
-        IsoChronList::iterator it = origin.end();
+        IsoChronList::const_iterator it = origin.end();
         it--;
         for(double x = r.x + xoff; x<r.x+r.width; x+=step) {
             for(double y = r.y + yoff; y<r.y+r.height; y+=step) {
@@ -1105,7 +1337,6 @@ void RouteMapOverlay::RenderWindBarbs(piDC &dc, PlugIn_ViewPort &vp)
             }
         }
 
-        Unlock();
 
         // evaluate performance, and "cheat" by spacing the barbes more in subsequent frames if
         // peformance is inadequate
@@ -1165,6 +1396,8 @@ void RouteMapOverlay::RenderWindBarbs(piDC &dc, PlugIn_ViewPort &vp)
 
 void RouteMapOverlay::RenderCurrent(piDC &dc, PlugIn_ViewPort &vp)
 {
+    IsoChronSnapshot snapshot = Origin();
+    const IsoChronList &origin = *snapshot;
     if(origin.size() < 2) // no map to work with
         return;
 
@@ -1217,13 +1450,11 @@ void RouteMapOverlay::RenderCurrent(piDC &dc, PlugIn_ViewPort &vp)
             nvp = vp;
         }
 
-        Lock();
-
         wxPoint p;
         WR_GetCanvasPixLL( &nvp, &p, configuration.StartLat, configuration.StartLon );
         int xoff = p.x%(int)step, yoff = p.y%(int)step;
 
-        IsoChronList::iterator it = origin.end();
+        IsoChronList::const_iterator it = origin.end();
         it--;
         for(double x = r.x + xoff; x<r.x+r.width; x+=step) {
             for(double y = r.y + yoff; y<r.y+r.height; y+=step) {
@@ -1303,7 +1534,6 @@ void RouteMapOverlay::RenderCurrent(piDC &dc, PlugIn_ViewPort &vp)
             }
         }
 
-        Unlock();
 
         // evaluate performance, and "cheat" by spacing the barbes more in subsequent frames if
         // peformance is inadequate
@@ -1366,7 +1596,8 @@ void RouteMapOverlay::GetLLBounds(double &latmin, double &latmax, double &lonmin
     latmin = INFINITY, lonmin = INFINITY;
     latmax = -INFINITY, lonmax = -INFINITY;
 
-    IsoChron *last = origin.back();
+    IsoChronSnapshot origin = Origin();
+    IsoChron *last = origin->back().get();
     for(IsoRouteList::iterator it = last->routes.begin(); it != last->routes.end(); ++it) {
         Position *pos = (*it)->skippoints->point;
         do {
@@ -1379,24 +1610,22 @@ void RouteMapOverlay::GetLLBounds(double &latmin, double &latmax, double &lonmin
     }
 }
 
-void RouteMapOverlay::RequestGrib(wxDateTime time)
+Shared_GribRecordSet RouteMapOverlay::RequestGrib(wxDateTime time)
 {
     Json::Value v;
-    time = time.FromUTC();
-    v["Day"] = time.GetDay();
-    v["Month"] = time.GetMonth();
-    v["Year"] = time.GetYear();
-    v["Hour"] = time.GetHour();
-    v["Minute"] = time.GetMinute();
-    v["Second"] = time.GetSecond();
+    wxDateTime local = time.FromUTC();
+    v["Day"] = local.GetDay();
+    v["Month"] = local.GetMonth();
+    v["Year"] = local.GetYear();
+    v["Hour"] = local.GetHour();
+    v["Minute"] = local.GetMinute();
+    v["Second"] = local.GetSecond();
 
     Json::FastWriter w;
 
     SendPluginMessage("GRIB_TIMELINE_RECORD_REQUEST", w.write(v));
 
-    Lock();
-    m_bNeedsGrib = false;
-    Unlock();
+    return RequestedGrib(time);
 }
 
 std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
@@ -1407,6 +1636,7 @@ std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
         plotdata.clear();
     }
     if(plotdata.empty()) {
+        m_RouteSummary[cursor_route].valid = false;
         Position *next = cursor_route ? last_cursor_position : last_destination_position;
 
         if(!next)
@@ -1415,14 +1645,13 @@ std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
         Position *pos = next->parent;
 
         RouteMapConfiguration configuration = GetConfiguration();
-        Lock();
-        IsoChronList::iterator it = origin.begin(), itp;
+        IsoChronSnapshot snapshot = Origin();
+        const IsoChronList &origin = *snapshot;
+        IsoChronList::const_iterator it = origin.begin(), itp;
 
         for(Position *p = pos; p; p=p->parent)
-            if(++it == origin.end()) {
-                Unlock();
+            if(++it == origin.end())
                 return plotdata;
-            }
         it--;
 
         while(pos) {
@@ -1433,7 +1662,9 @@ std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
             configuration.time = (*it)->time;
             //printf("grib time %p %d\n", configuration.grib, configuration.time);
 
-            configuration.UsedDeltaTime = (*it)->delta;
+            /* isochrons may be shared with other destinations, so the last leg's
+               time is kept here rather than in the isochron */
+            configuration.UsedDeltaTime = next == destination_position ? m_DestinationDelta : (*it)->delta;
             PlotData data;
 
             double dt = configuration.UsedDeltaTime;
@@ -1446,8 +1677,6 @@ std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
             next = pos;
             pos = pos->parent;
         }
-
-        Unlock();
     }
     return plotdata;
 }
@@ -1455,107 +1684,75 @@ std::list<PlotData> &RouteMapOverlay::GetPlotData(bool cursor_route)
 double RouteMapOverlay::RouteInfo(enum RouteInfoType type, bool cursor_route)
 {
     std::list<PlotData> &plotdata = GetPlotData(cursor_route);
+    RouteSummary &summary = m_RouteSummary[cursor_route];
+    if(!summary.valid)
+        UpdateRouteSummary(plotdata, summary);
 
-    double total = 0, count = 0, lat0 = 0, lon0 = 0;
-    int comfort = 0, current_comfort = 0;
+    double value = summary.values[type];
+    if(type == DISTANCE && !std::isnan(value) && Finished()) {
+        RouteMapConfiguration configuration = GetConfiguration();
+        value += DistGreatCircle_Plugin(summary.lastlat, summary.lastlon,
+                                        configuration.EndLat, configuration.EndLon);
+    }
+    return value;
+}
+
+static inline void Max(double &m, double v)
+{
+    if(m < v) // keeps m if v is nan
+        m = v;
+}
+
+void RouteMapOverlay::UpdateRouteSummary(std::list<PlotData> &plotdata, RouteSummary &summary)
+{
+    double *v = summary.values;
+    for(int i = 0; i <= COMFORT; i++)
+        v[i] = 0;
+
+    double lat0 = 0, lon0 = 0;
+    int count = 0;
     for(std::list<PlotData>::iterator it=plotdata.begin(); it!=plotdata.end(); it++)
     {
-        switch(type) {
-        case DISTANCE:
-        {
-            if(it != plotdata.begin())
-                total += DistGreatCircle_Plugin(lat0, lon0, it->lat, it->lon);
-
-            lat0 = it->lat;
-            lon0 = it->lon;
-        } break;
-        case AVGSPEED:
-            total += it->VB;
-            break;
-        case MAXSPEED:
-            if(total < it->VB)
-                total = it->VB;
-            break;
-        case AVGSPEEDGROUND:
-            total += it->VBG;
-            break;
-        case MAXSPEEDGROUND:
-            if(total < it->VBG)
-               total = it->VBG;
-            break;
-        case AVGWIND:
-            total += it->VW;
-            break;
-        case MAXWIND:
-            if(total < it->VW)
-                total = it->VW;
-            break;
-        case MAXWINDGUST:
-            if(total < it->VW_GUST)
-                total = it->VW_GUST;
-            break;
-        case AVGCURRENT:
-            total += it->VC;
-            break;
-        case MAXCURRENT:
-            if(total < it->VC)
-                total = it->VC;
-            break;
-        case AVGSWELL:
-            total += it->WVHT;
-            break;
-        case MAXSWELL:
-            if(total < it->WVHT)
-                total = it->WVHT;
-            break;
-        case PERCENTAGE_UPWIND:
-            if(fabs(heading_resolve(it->B - it->W)) < 90)
-                total++;
-            break;
-        case PORT_STARBOARD:
-            if(heading_resolve(it->B - it->W) > 0)
-                total++;
-            break;
+        if(it != plotdata.begin())
+            v[DISTANCE] += DistGreatCircle_Plugin(lat0, lon0, it->lat, it->lon);
+        lat0 = it->lat;
+        lon0 = it->lon;
+
+        v[AVGSPEED] += it->VB;
+        Max(v[MAXSPEED], it->VB);
+        v[AVGSPEEDGROUND] += it->VBG;
+        Max(v[MAXSPEEDGROUND], it->VBG);
+        v[AVGWIND] += it->VW;
+        Max(v[MAXWIND], it->VW);
+        Max(v[MAXWINDGUST], it->VW_GUST);
+        v[AVGCURRENT] += it->VC;
+        Max(v[MAXCURRENT], it->VC);
+        v[AVGSWELL] += it->WVHT;
+        Max(v[MAXSWELL], it->WVHT);
+        if(fabs(heading_resolve(it->B - it->W)) < 90)
+            v[PERCENTAGE_UPWIND]++;
+        if(heading_resolve(it->B - it->W) > 0)
+            v[PORT_STARBOARD]++;
         // CUSTOMIZATION
         // Comfort on route
-        case COMFORT:
-            current_comfort = sailingConditionLevel(*it);
-            if (current_comfort > comfort)
-                comfort = current_comfort;
-            break;
-        default:
-            break;
-        }
+        Max(v[COMFORT], sailingConditionLevel(*it));
         count++;
     }
 
     /* fixup data */
-    switch(type) {
-    case TACKS:
-        return plotdata.size() ? plotdata.back().tacks : 0;
-    case DISTANCE:
-        if(total == 0)
-            total = NAN;
-        else if(Finished()) {
-            RouteMapConfiguration configuration = GetConfiguration();
-            total += DistGreatCircle_Plugin(lat0, lon0, configuration.EndLat, configuration.EndLon);
-        }
-        return total;
-    case COMFORT:
-        return comfort;
-    case PERCENTAGE_UPWIND:
-    case PORT_STARBOARD:
-        total *= 100.0;
-    case AVGSPEED:
-    case AVGSPEEDGROUND:
-    case AVGWIND:
-    case AVGCURRENT:
-    case AVGSWELL:
-        total /= count;
-    default:
-        break;
-    }
-    return total;
+    if(v[DISTANCE] == 0)
+        v[DISTANCE] = NAN;
+    v[TACKS] = plotdata.size() ? plotdata.back().tacks : 0;
+    v[PERCENTAGE_UPWIND] *= 100.0;
+    v[PORT_STARBOARD] *= 100.0;
+
+    static const RouteInfoType averages[] = {AVGSPEED, AVGSPEEDGROUND, AVGWIND, AVGCURRENT, AVGSWELL,
+                                             PERCENTAGE_UPWIND, PORT_STARBOARD};
+    for(unsigned int i = 0; i < (sizeof averages) / (sizeof *averages); i++)
+        v[averages[i]] /= count;
+
+    summary.lastlat = lat0, summary.lastlon = lon0;
+    summary.valid = true;
 }
 
 /* how many cyclone tracks did we cross? which month? */
@@ -1567,9 +1764,12 @@ int RouteMapOverlay::Cyclones(int *months)
     int days = 30; // search for 30 day range
     int cyclones = 0;
 
+    IsoChronSnapshot snapshot = Origin();
+    const IsoChronList &origin = *snapshot;
+
     Lock();
     wxDateTime ptime = m_EndTime;
-    IsoChronList::iterator it = origin.end();
+    IsoChronList::const_iterator it = origin.end();
 
     for(Position *p = destination_position; p && p->parent; p = p->parent) {
         if(RouteMap::ClimatologyCycloneTrackCrossings(p->parent->lat, p->parent->lon,
@@ -1596,6 +1796,8 @@ void RouteMapOverlay::Clear()
     // clear_cursor_plotdata = false;
     last_cursor_plotdata.clear();
     last_destination_plotdata.clear();
+    m_IsoChronLines.clear();
+    m_DestinationOrigin.reset();
     m_UpdateOverlay = true;
 }
 
@@ -1627,6 +1829,12 @@ bool RouteMapOverlay::Updated()
 
 void RouteMapOverlay::UpdateDestination()
 {
+    /* nothing new while propagating on for followers past the destination */
+    IsoChronSnapshot snapshot = Origin();
+    if(snapshot == m_DestinationOrigin)
+        return;
+    m_DestinationOrigin = snapshot;
+
     RouteMapConfiguration configuration = GetConfiguration();
     Position *last_last_destination_position = last_destination_position;
     bool done = ReachedDestination();
@@ -1634,26 +1842,25 @@ void RouteMapOverlay::UpdateDestination()
         Lock();
         delete destination_position;
         destination_position = 0;
-        /* this doesn't happen often, so can be slow.. for each position in the last
-           isochron, we try to propagate to the destination */
-        IsoChronList::iterator iit = origin.end();
+        /* for each position in the last isochron, we try to propagate to the destination */
+        IsoChronSnapshot origin = Origin();
+        IsoChronList::const_iterator iit = origin->end();
         iit--; iit--; /* second from last isochron */
-        IsoChron *isochron = *iit;
+        IsoChron *isochron = iit->get();
         double mindt = INFINITY;
         Position *endp;
         double minH;
         bool mintacked;
         int mindata_mask;
+        int minpolar;
 
-        for(IsoRouteList::iterator it = isochron->routes.begin(); it != isochron->routes.end(); ++it) {
-            configuration.grib = isochron->m_Grib;
-            configuration.grib_is_data_deficient = isochron->m_Grib_is_data_deficient;
+        configuration.grib = isochron->m_Grib;
+        configuration.grib_is_data_deficient = isochron->m_Grib_is_data_deficient;
 
-            configuration.time = isochron->time;
-            configuration.UsedDeltaTime = isochron->delta;
-            (*it)->PropagateToEnd(configuration, mindt, endp, minH,
-                                  mintacked, mindata_mask);
-        }
+        configuration.time = isochron->time;
+        configuration.UsedDeltaTime = isochron->delta;
+        isochron->PropagateToEnd(configuration, mindt, endp, minH,
+                                 mintacked, mindata_mask, minpolar);
         Unlock();
 
         if(std::isinf(mindt)) {
@@ -1666,11 +1873,11 @@ void RouteMapOverlay::UpdateDestination()
         }
         else {
             destination_position = new Position(configuration.EndLat, configuration.EndLon,
-                                            endp, minH, NAN, endp->polar, endp->tacks + mintacked,
+                                            endp, minH, NAN, minpolar, endp->tacks + mintacked,
                                             mindata_mask);
 
             m_EndTime = isochron->time +wxTimeSpan::Milliseconds(1000*mindt);
-            isochron->delta = mindt;
+            m_DestinationDelta = mindt;
             last_destination_position = destination_position;
         }
     }
@@ -753,7 +753,7 @@ void WeatherRouting::UpdateCursorPositionDialog()
     if(p->polar == -1)
         dlg.m_stPolar->SetLabel(wxEmptyString);
     else {
-        wxFileName fn = configuration.boat.Polars[p->polar].FileName;
+        wxFileName fn = configuration.GetBoat().Polars[p->polar].FileName;
         dlg.m_stPolar->SetLabel(fn.GetFullName());
     }
 
@@ -852,7 +852,7 @@ void WeatherRouting::UpdateRoutePositionDialog()
     if(data.polar == -1)
         dlg.m_stPolar->SetLabel(wxEmptyString);
     else {
-        wxFileName fn = configuration.boat.Polars[data.polar].FileName;
+        wxFileName fn = configuration.GetBoat().Polars[data.polar].FileName;
         dlg.m_stPolar->SetLabel(fn.GetFullName());
     }
     
@@ -1433,6 +1433,8 @@ void WeatherRouting::GenerateBatch()
             for(std::vector<BatchSource*>::iterator it = dlg.sources.begin();
                 it != dlg.sources.end(); it++) {
                 configuration.Start = (*it)->Name;
+                /* the destinations of one source share its isochrons */
+                configuration.ShareIsochrons = (*it)->destinations.size() > 1;
 
                 for(std::list<BatchDestination*>::iterator it2 = (*it)->destinations.begin();
                     it2 != (*it)->destinations.end(); it2++) {
@@ -1588,13 +1590,43 @@ void WeatherRouting::OnAbout ( wxCommandEvent& event )
     dlg.ShowModal();
 }
 
+/* configurations propagating the same isochrons, except for destination pruning */
+static bool SameIsochrons(const RouteMapConfiguration &a, const RouteMapConfiguration &b)
+{
+    return a.ShareIsochrons && b.ShareIsochrons &&
+        a.RouteGUID.IsEmpty() && b.RouteGUID.IsEmpty() &&
+        a.Start == b.Start && a.StartLat == b.StartLat && a.StartLon == b.StartLon &&
+        a.StartTime == b.StartTime && a.DeltaTime == b.DeltaTime &&
+        a.boatFileName == b.boatFileName &&
+        a.Integrator == b.Integrator && a.GeodesyMode == b.GeodesyMode &&
+        a.MaxSearchAngle == b.MaxSearchAngle &&
+        a.MaxTrueWindKnots == b.MaxTrueWindKnots &&
+        a.MaxApparentWindKnots == b.MaxApparentWindKnots &&
+        a.MaxSwellMeters == b.MaxSwellMeters && a.MaxLatitude == b.MaxLatitude &&
+        a.TackingTime == b.TackingTime && a.WindVSCurrent == b.WindVSCurrent &&
+        a.SafetyMarginLand == b.SafetyMarginLand &&
+        a.AvoidCycloneTracks == b.AvoidCycloneTracks &&
+        a.CycloneMonths == b.CycloneMonths && a.CycloneDays == b.CycloneDays &&
+        a.CycloneCells == b.CycloneCells &&
+        a.UseGrib == b.UseGrib && a.ClimatologyType == b.ClimatologyType &&
+        a.AllowDataDeficient == b.AllowDataDeficient && a.WindStrength == b.WindStrength &&
+        a.DetectLand == b.DetectLand && a.DetectBoundary == b.DetectBoundary &&
+        a.Currents == b.Currents && a.OptimizeTacking == b.OptimizeTacking &&
+        a.InvertedRegions == b.InvertedRegions && a.Anchoring == b.Anchoring &&
+        a.FromDegree == b.FromDegree && a.ToDegree == b.ToDegree &&
+        a.ByDegrees == b.ByDegrees && a.AdaptiveHeadings == b.AdaptiveHeadings &&
+        a.positive_longitudes == b.positive_longitudes;
+}
+
 void WeatherRouting::OnComputationTimer( wxTimerEvent & )
 {
+    int threads = 0;
     for(std::list<RouteMapOverlay*>::iterator it = m_RunningRouteMaps.begin();
         it != m_RunningRouteMaps.end(); ) {
         RouteMapOverlay *routemapoverlay = *it;
         if(!routemapoverlay->Running()) {
             routemapoverlay->DeleteThread();
+            routemapoverlay->Unfollow();
 
             it = m_RunningRouteMaps.erase(it);
 
@@ -1602,7 +1634,7 @@ void WeatherRouting::OnComputationTimer( wxTimerEvent & )
             UpdateRouteMap(routemapoverlay);
 
             /* update report if needed */
-            m_ReportDialog.m_bReportStale = true;
+            m_ReportDialog.RouteFinished(routemapoverlay);
             if(m_ReportDialog.IsShown()) {
                 std::list<RouteMapOverlay *>routemapoverlays = CurrentRouteMaps();
                 for(std::list<RouteMapOverlay *>::iterator it = routemapoverlays.begin();
@@ -1617,22 +1649,75 @@ void WeatherRouting::OnComputationTimer( wxTimerEvent & )
         } else
             it++;
 
+        /* followers are propagated by another route map */
+        if(routemapoverlay->Following())
+            continue;
+        threads++;
+
         /* get a new grib for the route map if needed */
         if(routemapoverlay->NeedsGrib() && !routemapoverlay->Finished()) {
-            m_RouteMapOverlayNeedingGrib = routemapoverlay;
-            routemapoverlay->RequestGrib(routemapoverlay->NewTime());
-            m_RouteMapOverlayNeedingGrib = NULL;
+            wxDateTime time = routemapoverlay->GribRequestTime();
+            std::map<wxDateTime, Shared_GribRecordSet>::iterator git = m_RequestedGribs.find(time);
+            if(git != m_RequestedGribs.end()) {
+                routemapoverlay->Lock();
+                routemapoverlay->SetSharedGrib(git->second);
+                routemapoverlay->Unlock();
+                routemapoverlay->RequestedGrib(time);
+            } else {
+                m_RouteMapOverlayNeedingGrib = routemapoverlay;
+                Shared_GribRecordSet grib = routemapoverlay->RequestGrib(time);
+                m_RouteMapOverlayNeedingGrib = NULL;
+                /* a failed request is tried again by the next map needing it */
+                if(grib.GetGribRecordSet())
+                    m_RequestedGribs[time] = grib;
+            }
         }
     }
 
-    if((int)m_RunningRouteMaps.size() < m_SettingsDialog.m_sConcurrentThreads->GetValue()
+    /* drop gribs for times before any running route map still requests */
+    wxDateTime earliest;
+    for(std::list<RouteMapOverlay*>::iterator it = m_RunningRouteMaps.begin();
+        it != m_RunningRouteMaps.end(); it++)
+        if(!(*it)->Following() && (!earliest.IsValid() || (*it)->GribRequestTime() < earliest))
+            earliest = (*it)->GribRequestTime();
+    while(m_RequestedGribs.size() &&
+          (!earliest.IsValid() || m_RequestedGribs.begin()->first < earliest))
+        m_RequestedGribs.erase(m_RequestedGribs.begin());
+
+    if(threads < m_SettingsDialog.m_sConcurrentThreads->GetValue()
        && m_WaitingRouteMaps.size()) {
         RouteMapOverlay *routemapoverlay = m_WaitingRouteMaps.front();
         m_WaitingRouteMaps.pop_front();
+
+        /* waiting maps only differing in destination follow this one,
+           they must be attached before its thread starts propagating */
+        std::list<RouteMapOverlay*> followers;
+        RouteMapConfiguration configuration = routemapoverlay->GetConfiguration();
+        for(std::list<RouteMapOverlay*>::iterator it = m_WaitingRouteMaps.begin();
+            it != m_WaitingRouteMaps.end(); ) {
+            if((*it)->Valid() && SameIsochrons(configuration, (*it)->GetConfiguration())) {
+                (*it)->Follow(routemapoverlay);
+                followers.push_back(*it);
+                it = m_WaitingRouteMaps.erase(it);
+            } else
+                it++;
+        }
+
         wxString error;
-        if(routemapoverlay->Start(error))
+        if(routemapoverlay->Start(error)) {
             m_RunningRouteMaps.push_back(routemapoverlay);
-        else {
+            for(std::list<RouteMapOverlay*>::iterator it = followers.begin(); it != followers.end(); it++) {
+                (*it)->LoadBoat(); // for plot data
+                m_RunningRouteMaps.push_back(*it);
+                UpdateRouteMap(*it);
+            }
+        } else {
+            for(std::list<RouteMapOverlay*>::reverse_iterator it = followers.rbegin();
+                it != followers.rend(); it++) {
+                (*it)->Unfollow();
+                m_WaitingRouteMaps.push_front(*it);
+            }
+
             wxMessageDialog mdlg(this, _("Failed to start configuration: ") + error,
                                  _("Weather Routing"), wxOK | wxICON_ERROR);
             mdlg.ShowModal();
@@ -1701,7 +1786,7 @@ bool WeatherRouting::OpenXML(wxString filename, bool reportfailure)
     wxDateTime start = wxDateTime::UNow();
 
     wxString lastboatFileName;
-    Boat lastboat;
+    RouteMapConfiguration lastboat;
 
     if(!doc.LoadFile(filename.mb_str()))
         FAIL(_("Failed to load file."));
@@ -1792,6 +1877,8 @@ bool WeatherRouting::OpenXML(wxString filename, bool reportfailure)
             
                 configuration.Integrator = (RouteMapConfiguration::IntegratorType)
                     AttributeInt(e, "Integrator", 0);
+                configuration.GeodesyMode = (Geodesy::Mode)
+                    AttributeInt(e, "Geodesy", Geodesy::ELLIPSOIDAL);
 
                 configuration.MaxDivertedCourse = AttributeDouble(e, "MaxDivertedCourse", 90);
                 configuration.MaxCourseAngle = AttributeDouble(e, "MaxCourseAngle", 180);
@@ -1803,12 +1890,16 @@ bool WeatherRouting::OpenXML(wxString filename, bool reportfailure)
                 configuration.MaxLatitude = AttributeDouble(e, "MaxLatitude", 90);
                 configuration.TackingTime = AttributeDouble(e, "TackingTime", 0);
                 configuration.WindVSCurrent = AttributeDouble(e, "WindVSCurrent", 0);
+                configuration.MaxPassageHours = AttributeDouble(e, "MaxPassageHours", 0);
+                configuration.CorridorMiles = AttributeDouble(e, "CorridorMiles", 0);
 
                 configuration.AvoidCycloneTracks = AttributeBool(e, "AvoidCycloneTracks", false);
                 configuration.CycloneMonths = AttributeInt(e, "CycloneMonths", 2);
                 configuration.CycloneDays = AttributeInt(e, "CycloneDays", 0);
+                configuration.CycloneCells = AttributeBool(e, "CycloneCells", false);
 
                 configuration.UseGrib = AttributeBool(e, "UseGrib", true);
+                configuration.PrefetchDepth = AttributeInt(e, "PrefetchDepth", 4);
                 configuration.ClimatologyType = (RouteMapConfiguration::ClimatologyDataType)
                     AttributeInt(e, "ClimatologyType", RouteMapConfiguration::CUMULATIVE_MAP);
                 configuration.AllowDataDeficient = AttributeBool(e, "AllowDataDeficient", false);
@@ -1822,19 +1913,22 @@ bool WeatherRouting::OpenXML(wxString filename, bool reportfailure)
                 
                 configuration.InvertedRegions = AttributeBool(e, "InvertedRegions", false);
                 configuration.Anchoring = AttributeBool(e, "Anchoring", false);
+                configuration.ShareIsochrons = AttributeBool(e, "ShareIsochrons", false);
+                configuration.AdaptiveHeadings = AttributeBool(e, "AdaptiveHeadings", false);
+                configuration.DeferValidation = AttributeBool(e, "DeferValidation", false);
 
                 configuration.FromDegree = AttributeDouble(e, "FromDegree", 0);
                 configuration.ToDegree = AttributeDouble(e, "ToDegree", 180);
                 configuration.ByDegrees = AttributeDouble(e, "ByDegrees", 5);
 
                 if(configuration.boatFileName == lastboatFileName)
-                    configuration.boat = lastboat;
+                    configuration.ShareBoat(lastboat);
             
                 AddConfiguration(configuration);
 
                 lastboatFileName = configuration.boatFileName;
                 m_WeatherRoutes.back()->routemapoverlay->LoadBoat();
-                lastboat = m_WeatherRoutes.back()->routemapoverlay->GetConfiguration().boat;
+                lastboat = m_WeatherRoutes.back()->routemapoverlay->GetConfiguration();
             } else
                 FAIL(_("Unrecognized xml node"));
         }
@@ -1901,6 +1995,7 @@ void WeatherRouting::SaveXML(wxString filename)
         c->SetAttribute("Boat", configuration.boatFileName.ToUTF8());
 
         c->SetAttribute("Integrator", configuration.Integrator);
+        c->SetAttribute("Geodesy", configuration.GeodesyMode);
 
         c->SetAttribute("MaxDivertedCourse", configuration.MaxDivertedCourse);
         c->SetAttribute("MaxCourseAngle", configuration.MaxCourseAngle);
@@ -1912,12 +2007,16 @@ void WeatherRouting::SaveXML(wxString filename)
         c->SetAttribute("MaxLatitude", configuration.MaxLatitude);
         c->SetAttribute("TackingTime", configuration.TackingTime);
         c->SetAttribute("WindVSCurrent", configuration.WindVSCurrent);
+        c->SetDoubleAttribute("MaxPassageHours", configuration.MaxPassageHours);
+        c->SetDoubleAttribute("CorridorMiles", configuration.CorridorMiles);
 
         c->SetAttribute("AvoidCycloneTracks", configuration.AvoidCycloneTracks);
         c->SetAttribute("CycloneMonths", configuration.CycloneMonths);
         c->SetAttribute("CycloneDays", configuration.CycloneDays);
+        c->SetAttribute("CycloneCells", configuration.CycloneCells);
 
         c->SetAttribute("UseGrib", configuration.UseGrib);
+        c->SetAttribute("PrefetchDepth", configuration.PrefetchDepth);
         c->SetAttribute("ClimatologyType", configuration.ClimatologyType);
         c->SetAttribute("AllowDataDeficient", configuration.AllowDataDeficient);
         c->SetDoubleAttribute("WindStrength", configuration.WindStrength);
@@ -1930,6 +2029,9 @@ void WeatherRouting::SaveXML(wxString filename)
 
         c->SetAttribute("InvertedRegions", configuration.InvertedRegions);
         c->SetAttribute("Anchoring", configuration.Anchoring);
+        c->SetAttribute("ShareIsochrons", configuration.ShareIsochrons);
+        c->SetAttribute("AdaptiveHeadings", configuration.AdaptiveHeadings);
+        c->SetAttribute("DeferValidation", configuration.DeferValidation);
 
         c->SetDoubleAttribute("FromDegree", configuration.FromDegree);
         c->SetDoubleAttribute("ToDegree", configuration.ToDegree);
@@ -2562,6 +2664,7 @@ void WeatherRouting::Stop()
         while((*it)->Running())
             wxThread::Sleep(100);
 
+        (*it)->Unfollow();
         (*it)->ResetFinished();
         (*it)->DeleteThread();
 
@@ -2595,6 +2698,7 @@ void WeatherRouting::Reset()
             reinterpret_cast<WeatherRoute*>(wxUIntToPtr(m_panel->m_lWeatherRoutes->GetItemData(i)));
         weatherroute->routemapoverlay->Reset();
     }
+    m_ReportDialog.m_bReportStale = true;
     m_positionOnRoute = nullptr;
     UpdateDialogs();
 
@@ -2679,6 +2783,7 @@ RouteMapConfiguration WeatherRouting::DefaultConfiguration()
         _T("boats") + wxFileName::GetPathSeparator() + _T("Boat.xml");
     
     configuration.Integrator = RouteMapConfiguration::NEWTON;
+    configuration.GeodesyMode = Geodesy::ELLIPSOIDAL;
 
     configuration.MaxDivertedCourse = 90;
     configuration.MaxCourseAngle = 180;
@@ -2690,12 +2795,16 @@ RouteMapConfiguration WeatherRouting::DefaultConfiguration()
     configuration.MaxLatitude = 90;
     configuration.TackingTime = 0;
     configuration.WindVSCurrent = 0;
+    configuration.MaxPassageHours = 0;
+    configuration.CorridorMiles = 0;
     
     configuration.AvoidCycloneTracks = false;
     configuration.CycloneMonths = 1;
     configuration.CycloneDays = 0;
+    configuration.CycloneCells = false;
 
     configuration.UseGrib = true;
+    configuration.PrefetchDepth = 4;
     configuration.ClimatologyType = RouteMapConfiguration::MOST_LIKELY;
     configuration.AllowDataDeficient = false;
     configuration.WindStrength = 1;
@@ -2706,6 +2815,9 @@ RouteMapConfiguration WeatherRouting::DefaultConfiguration()
     configuration.OptimizeTacking = false;
     configuration.InvertedRegions = false;
     configuration.Anchoring = false;
+    configuration.ShareIsochrons = false;
+    configuration.AdaptiveHeadings = false;
+    configuration.DeferValidation = false;
 
     configuration.FromDegree = 0;
     configuration.ToDegree = 180;
@@ -1037,6 +1037,9 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 
 	fgSizer941->Add( fgSizer952, 1, wxEXPAND, 5 );
 
+	m_cbCycloneCells = new wxCheckBox( sbConstraints1->GetStaticBox(), wxID_ANY, _("Test 1 degree cells first (faster, may miss tracks)"), wxDefaultPosition, wxDefaultSize, wxCHK_3STATE );
+	fgSizer941->Add( m_cbCycloneCells, 0, wxALL, 5 );
+
 
 	sbConstraints1->Add( fgSizer941, 1, wxEXPAND, 5 );
 
@@ -1070,6 +1073,15 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 	m_cbAnchoring = new wxCheckBox( sbOptions1->GetStaticBox(), wxID_ANY, _("Anchoring"), wxDefaultPosition, wxDefaultSize, wxCHK_3STATE );
 	fgSizer1121->Add( m_cbAnchoring, 0, wxALL, 5 );
 
+	m_cbAdaptiveHeadings = new wxCheckBox( sbOptions1->GetStaticBox(), wxID_ANY, _("Adaptive Headings"), wxDefaultPosition, wxDefaultSize, wxCHK_3STATE );
+	fgSizer1121->Add( m_cbAdaptiveHeadings, 0, wxALL, 5 );
+
+	m_cbDeferValidation = new wxCheckBox( sbOptions1->GetStaticBox(), wxID_ANY, _("Defer Validation"), wxDefaultPosition, wxDefaultSize, wxCHK_3STATE );
+	fgSizer1121->Add( m_cbDeferValidation, 0, wxALL, 5 );
+
+	m_cbShareIsochrons = new wxCheckBox( sbOptions1->GetStaticBox(), wxID_ANY, _("Share Isochrons"), wxDefaultPosition, wxDefaultSize, wxCHK_3STATE );
+	fgSizer1121->Add( m_cbShareIsochrons, 0, wxALL, 5 );
+
 
 	fgSizer113->Add( fgSizer1121, 1, wxEXPAND, 5 );
 
@@ -1087,6 +1099,16 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 	m_cIntegrator->Append( _("Runge Kutta") );
 	fgSizer115->Add( m_cIntegrator, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
 
+	m_staticText1391 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Geodesy"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText1391->Wrap( -1 );
+	fgSizer115->Add( m_staticText1391, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_cGeodesyMode = new wxComboBox( sbOptions1->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize, 0, NULL, wxCB_READONLY );
+	m_cGeodesyMode->Append( _("Ellipsoidal") );
+	m_cGeodesyMode->Append( _("Spherical") );
+	m_cGeodesyMode->Append( _("Local Tangent") );
+	fgSizer115->Add( m_cGeodesyMode, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
+
 
 	fgSizer113->Add( fgSizer115, 1, wxEXPAND, 5 );
 
@@ -1147,6 +1169,63 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 
 	fgSizer113->Add( fgSizer11511, 1, wxEXPAND, 5 );
 
+	wxFlexGridSizer* fgSizer11512;
+	fgSizer11512 = new wxFlexGridSizer( 1, 0, 0, 0 );
+	fgSizer11512->SetFlexibleDirection( wxBOTH );
+	fgSizer11512->SetNonFlexibleGrowMode( wxFLEX_GROWMODE_SPECIFIED );
+
+	m_staticText242 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Grib Prefetch"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText242->Wrap( -1 );
+	fgSizer11512->Add( m_staticText242, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_sPrefetchDepth = new wxSpinCtrl( sbOptions1->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 140,-1 ), wxSP_ARROW_KEYS, 0, 32, 4 );
+	fgSizer11512->Add( m_sPrefetchDepth, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
+
+	m_staticText1212 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Time Steps"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText1212->Wrap( -1 );
+	fgSizer11512->Add( m_staticText1212, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+
+	fgSizer113->Add( fgSizer11512, 1, wxEXPAND, 5 );
+
+	wxFlexGridSizer* fgSizer11513;
+	fgSizer11513 = new wxFlexGridSizer( 1, 0, 0, 0 );
+	fgSizer11513->SetFlexibleDirection( wxBOTH );
+	fgSizer11513->SetNonFlexibleGrowMode( wxFLEX_GROWMODE_SPECIFIED );
+
+	m_staticText243 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Max Passage"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText243->Wrap( -1 );
+	fgSizer11513->Add( m_staticText243, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_sMaxPassageHours = new wxSpinCtrl( sbOptions1->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 140,-1 ), wxSP_ARROW_KEYS, 0, 10000, 0 );
+	fgSizer11513->Add( m_sMaxPassageHours, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
+
+	m_staticText1213 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Hours (0 for none)"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText1213->Wrap( -1 );
+	fgSizer11513->Add( m_staticText1213, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+
+	fgSizer113->Add( fgSizer11513, 1, wxEXPAND, 5 );
+
+	wxFlexGridSizer* fgSizer11514;
+	fgSizer11514 = new wxFlexGridSizer( 1, 0, 0, 0 );
+	fgSizer11514->SetFlexibleDirection( wxBOTH );
+	fgSizer11514->SetNonFlexibleGrowMode( wxFLEX_GROWMODE_SPECIFIED );
+
+	m_staticText244 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("Corridor"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText244->Wrap( -1 );
+	fgSizer11514->Add( m_staticText244, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+	m_sCorridorMiles = new wxSpinCtrl( sbOptions1->GetStaticBox(), wxID_ANY, wxEmptyString, wxDefaultPosition, wxSize( 140,-1 ), wxSP_ARROW_KEYS, 0, 1000, 0 );
+	fgSizer11514->Add( m_sCorridorMiles, 0, wxALL|wxALIGN_CENTER_VERTICAL, 5 );
+
+	m_staticText1214 = new wxStaticText( sbOptions1->GetStaticBox(), wxID_ANY, _("NM (0 for one pass)"), wxDefaultPosition, wxDefaultSize, 0 );
+	m_staticText1214->Wrap( -1 );
+	fgSizer11514->Add( m_staticText1214, 0, wxALIGN_CENTER_VERTICAL|wxALL, 5 );
+
+
+	fgSizer113->Add( fgSizer11514, 1, wxEXPAND, 5 );
+
 
 	sbOptions1->Add( fgSizer113, 1, wxEXPAND, 5 );
 
@@ -1347,9 +1426,14 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 	m_sCycloneMonths->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sCycloneDays->Connect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sCycloneDays->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_cbCycloneCells->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cbInvertedRegions->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cbAnchoring->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbAdaptiveHeadings->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbDeferValidation->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbShareIsochrons->Connect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cIntegrator->Connect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cGeodesyMode->Connect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_sWindStrength->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sTackingTime->Connect( wxEVT_LEFT_DOWN, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sTackingTime->Connect( wxEVT_LEFT_UP, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
@@ -1373,6 +1457,12 @@ ConfigurationDialogBase::ConfigurationDialogBase( wxWindow* parent, wxWindowID i
 	m_sTackingTime->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sSafetyMarginLand->Connect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sSafetyMarginLand->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sPrefetchDepth->Connect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sPrefetchDepth->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sMaxPassageHours->Connect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sMaxPassageHours->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sCorridorMiles->Connect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sCorridorMiles->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sFromDegree->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sToDegree->Connect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_tByDegrees->Connect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
@@ -1500,9 +1590,14 @@ ConfigurationDialogBase::~ConfigurationDialogBase()
 	m_sCycloneMonths->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sCycloneDays->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sCycloneDays->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_cbCycloneCells->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cbInvertedRegions->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cbAnchoring->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbAdaptiveHeadings->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbDeferValidation->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cbShareIsochrons->Disconnect( wxEVT_COMMAND_CHECKBOX_CLICKED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_cIntegrator->Disconnect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
+	m_cGeodesyMode->Disconnect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
 	m_sWindStrength->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sTackingTime->Disconnect( wxEVT_LEFT_DOWN, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sTackingTime->Disconnect( wxEVT_LEFT_UP, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
@@ -1526,6 +1621,12 @@ ConfigurationDialogBase::~ConfigurationDialogBase()
 	m_sTackingTime->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sSafetyMarginLand->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
 	m_sSafetyMarginLand->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sPrefetchDepth->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sPrefetchDepth->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sMaxPassageHours->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sMaxPassageHours->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
+	m_sCorridorMiles->Disconnect( wxEVT_MOTION, wxMouseEventHandler( ConfigurationDialogBase::EnableSpin ), NULL, this );
+	m_sCorridorMiles->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sFromDegree->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_sToDegree->Disconnect( wxEVT_COMMAND_SPINCTRL_UPDATED, wxSpinEventHandler( ConfigurationDialogBase::OnUpdateSpin ), NULL, this );
 	m_tByDegrees->Disconnect( wxEVT_COMMAND_TEXT_UPDATED, wxCommandEventHandler( ConfigurationDialogBase::OnUpdate ), NULL, this );
@@ -265,6 +265,9 @@ void weather_routing_pi::SetPluginMessage(wxString &message_id, wxString &messag
         Json::Value v;
         r.parse(static_cast<std::string>(message_body), v);
 
+        if (m_pWeather_Routing)
+            m_pWeather_Routing->m_RequestedGribs.clear();
+
         if (v["Day"].asInt() != -1) {
             wxDateTime time;
 
@@ -361,6 +364,7 @@ void weather_routing_pi::SetPluginMessage(wxString &message_id, wxString &messag
 
         sptr = v["ClimatologyCycloneTrackCrossingsPtr"].asString();
         sscanf(sptr.To8BitData().data(), "%p", &RouteMap::ClimatologyCycloneTrackCrossings);
+        RouteMap::ClearClimatologyCache();
 
         if(m_pWeather_Routing) {
             if (RouteMap::ClimatologyData == nullptr) {
@@ -374,7 +378,7 @@ void weather_routing_pi::SetPluginMessage(wxString &message_id, wxString &messag
     }
     else if (message_id == wxS("OCPN_DRAW_PI_READY_FOR_REQUESTS")) {
         if (message_body == "FALSE") {
-            RouteMap::ODFindClosestBoundaryLineCrossing = nullptr;
+            RouteMap::SetODFindClosestBoundaryLineCrossing(nullptr);
         }
         else if (message_body == "TRUE" && m_pWeather_Routing) {
             RequestOcpnDrawSetting();
@@ -397,7 +401,9 @@ void weather_routing_pi::SetPluginMessage(wxString &message_id, wxString &messag
             } else
             if(root["Msg"].asString() == "GetAPIAddresses" ) {
                 wxString sptr = root["OD_FindClosestBoundaryLineCrossing"].asString();
-                sscanf(sptr.To8BitData().data(), "%p", &RouteMap::ODFindClosestBoundaryLineCrossing);
+                OD_FindClosestBoundaryLineCrossing f = nullptr;
+                sscanf(sptr.To8BitData().data(), "%p", &f);
+                RouteMap::SetODFindClosestBoundaryLineCrossing(f);
             }
             else if (root["Msg"].asString() == "FindPointInAnyBoundary" ) {
               if (root["MsgId"].asString() == "exist") {